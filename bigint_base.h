@@ -26,9 +26,6 @@ const int32_t NTT_P2 = 104857601;
 const int32_t NTT_P2_INV = 74099389;
 #endif
 
-static std::vector<size_t> ntt_ra[NTT_POW];
-static size_t *ntt_r;
-
 uint32_t log2(uint32_t n) {
     uint32_t r = 0;
     if (n >= 0x10000) r += 16, n >>= 16;
@@ -41,7 +38,7 @@ uint32_t log2(uint32_t n) {
 
 template <int32_t NTT_MOD> struct NTT {
     typedef typename std::vector<ntt_base_t> ntt_vector_t;
-    ntt_vector_t ntt_a, ntt_b;
+    ntt_vector_t ntt_a, ntt_b, ntt_s;
     std::vector<int64_t> ntt_c;
     std::vector<ntt_vector_t> ntt_wa[2][NTT_POW];
 
@@ -64,9 +61,10 @@ template <int32_t NTT_MOD> struct NTT {
         }
         return (ntt_base_t)ans;
     }
-    void transform(ntt_base_t a[], size_t len, int on) {
+    // rev is the bit reversal table of len
+    void transform(ntt_base_t a[], size_t len, int on, const size_t *rev) {
         for (size_t i = 0; i < len; i++) {
-            if (i < ntt_r[i]) std::swap(a[i], a[ntt_r[i]]);
+            if (i < rev[i]) std::swap(a[i], a[rev[i]]);
         }
         uint32_t lg2 = log2(len);
         std::vector<ntt_vector_t> &ntt = ntt_wa[on][lg2];
@@ -108,44 +106,74 @@ template <int32_t NTT_MOD> struct NTT {
                 a[i] = mul_mod(a[i], inv);
         }
     }
-    void mul_conv(size_t n) {
-        transform(&ntt_a.front(), n, 1);
-        transform(&ntt_b.front(), n, 1);
+    void mul_conv(size_t n, const size_t *rev) {
+        transform(&ntt_a.front(), n, 1, rev);
+        transform(&ntt_b.front(), n, 1, rev);
         for (size_t i = 0; i < n; i++)
             ntt_a[i] = mul_mod(ntt_a[i], ntt_b[i]);
-        transform(&ntt_a.front(), n, 0);
+        transform(&ntt_a.front(), n, 0, rev);
+    }
+    void mul_conv(size_t n, const size_t *rev, const ntt_vector_t &fb) {
+        transform(&ntt_a.front(), n, 1, rev);
+        for (size_t i = 0; i < n; i++)
+            ntt_a[i] = mul_mod(ntt_a[i], fb[i]);
+        transform(&ntt_a.front(), n, 0, rev);
     }
-    void sqr_conv(size_t n) {
-        transform(&ntt_a.front(), n, 1);
+    void sqr_conv(size_t n, const size_t *rev) {
+        transform(&ntt_a.front(), n, 1, rev);
         for (size_t i = 0; i < n; i++)
             ntt_a[i] = mul_mod(ntt_a[i], ntt_a[i]);
-        transform(&ntt_a.front(), n, 0);
+        transform(&ntt_a.front(), n, 0, rev);
+    }
+    // adds the pointwise product of the transforms of ntt_a and ntt_b to ntt_s
+    void dot_conv(size_t n, const size_t *rev, bool sqr) {
+        transform(&ntt_a.front(), n, 1, rev);
+        if (!sqr) transform(&ntt_b.front(), n, 1, rev);
+        const ntt_vector_t &b = sqr ? ntt_a : ntt_b;
+        for (size_t i = 0; i < n; i++)
+            ntt_s[i] = (ntt_s[i] + mul_mod(ntt_a[i], b[i]) + NTT_MOD) % NTT_MOD;
     }
 };
 
-static NTT<NTT_P1> ntt1;
-static NTT<NTT_P2> ntt2;
+// the buffers and the tables of the products. there is a set per thread, so that the products can run
+// in several threads; a product looks its set up once and passes it to the functions below
+struct NTTBuffers {
+    NTT<NTT_P1> ntt1;
+    NTT<NTT_P2> ntt2;
+    std::vector<size_t> ra[NTT_POW];
+    const size_t *r;
+    NTTBuffers() : r(0) {}
+};
 
-void ntt_prepare(size_t size_a, size_t size_b, size_t &len, int flag = 1) {
-    len = 1;
-    size_t L1 = size_a, L2 = size_b;
-    int32_t id = log2(uint32_t(L1 + L2));
-    if (uint32_t(L1 + L2) > 1u << id) ++id;
-    len = size_t(1) << id;
-    ntt1.ntt_a.resize(len);
-    if (flag & 1) ntt1.ntt_b.resize(len);
-    if (flag & 2) ntt2.ntt_a = ntt1.ntt_a;
-    if (flag & 4) ntt2.ntt_b = ntt1.ntt_b;
-    if (ntt_ra[id].empty()) {
-        std::vector<size_t> &r = ntt_ra[id];
+static BIGINT_THREAD_LOCAL NTTBuffers ntt_buffers;
+
+// prepare the buffers for a cyclic convolution of length len, len must be a power of 2
+void ntt_prepare_cyclic(NTTBuffers &nb, size_t len, int flag = 1) {
+    int32_t id = log2(uint32_t(len));
+    nb.ntt1.ntt_a.resize(len);
+    if (flag & 1) nb.ntt1.ntt_b.resize(len);
+    if (flag & 2) nb.ntt2.ntt_a = nb.ntt1.ntt_a;
+    if (flag & 4) nb.ntt2.ntt_b = nb.ntt1.ntt_b;
+    if (nb.ra[id].empty()) {
+        std::vector<size_t> &r = nb.ra[id];
         r.resize(len);
         for (size_t i = 0; i < len; i++)
             r[i] = (r[i >> 1] >> 1) | ((i & 1) * (len >> 1));
     }
-    ntt_r = &ntt_ra[id].front();
+    nb.r = &nb.ra[id].front();
 }
 
-static void double_mod_rev(size_t n) {
+void ntt_prepare(NTTBuffers &nb, size_t size_a, size_t size_b, size_t &len, int flag = 1) {
+    size_t L1 = size_a, L2 = size_b;
+    int32_t id = log2(uint32_t(L1 + L2));
+    if (uint32_t(L1 + L2) > 1u << id) ++id;
+    len = size_t(1) << id;
+    ntt_prepare_cyclic(nb, len, flag);
+}
+
+static void double_mod_rev(NTTBuffers &nb, size_t n) {
+    NTT<NTT_P1> &ntt1 = nb.ntt1;
+    NTT<NTT_P2> &ntt2 = nb.ntt2;
     ntt1.ntt_c.resize(n);
     for (size_t i = 0; i < n; i++) {
         // z = x * p1 + c1 = y * p2 + c2 's solution is
@@ -155,20 +183,541 @@ static void double_mod_rev(size_t n) {
     }
 }
 
-void mul_conv() {
-    size_t n = ntt1.ntt_a.size();
-    ntt1.mul_conv(n);
-    ntt2.mul_conv(n);
-    double_mod_rev(n);
+void mul_conv(NTTBuffers &nb) {
+    size_t n = nb.ntt1.ntt_a.size();
+    nb.ntt1.mul_conv(n, nb.r);
+    nb.ntt2.mul_conv(n, nb.r);
+    double_mod_rev(nb, n);
+}
+
+// transform ntt_b in place and keep it, so that a fixed operand is transformed only once
+void ntt_cache(NTTBuffers &nb, std::vector<ntt_base_t> &fb1, std::vector<ntt_base_t> &fb2) {
+    size_t n = nb.ntt1.ntt_b.size();
+    nb.ntt1.transform(&nb.ntt1.ntt_b.front(), n, 1, nb.r);
+    nb.ntt2.transform(&nb.ntt2.ntt_b.front(), n, 1, nb.r);
+    fb1 = nb.ntt1.ntt_b;
+    fb2 = nb.ntt2.ntt_b;
 }
 
-void sqr_conv() {
-    size_t n = ntt1.ntt_a.size();
-    ntt1.sqr_conv(n);
-    ntt2.sqr_conv(n);
-    double_mod_rev(n);
+// the same as mul_conv, but ntt_b is replaced by the cached transform
+void mul_conv_cached(NTTBuffers &nb, const std::vector<ntt_base_t> &fb1, const std::vector<ntt_base_t> &fb2) {
+    size_t n = nb.ntt1.ntt_a.size();
+    nb.ntt1.mul_conv(n, nb.r, fb1);
+    nb.ntt2.mul_conv(n, nb.r, fb2);
+    double_mod_rev(nb, n);
 }
+
+void sqr_conv(NTTBuffers &nb) {
+    size_t n = nb.ntt1.ntt_a.size();
+    nb.ntt1.sqr_conv(n, nb.r);
+    nb.ntt2.sqr_conv(n, nb.r);
+    double_mod_rev(nb, n);
+}
+
+// sums of convolutions with one inverse transform: dot_prepare, then dot_add for each pair
+// in the buffers, prepared with the same cyclic length, and dot_conv leaves the sum in ntt_c.
+// the sum of the columns must stay below NTT_P1 * NTT_P2
+void dot_prepare(NTTBuffers &nb, size_t len) {
+    nb.ntt1.ntt_s.assign(len, 0);
+    nb.ntt2.ntt_s.assign(len, 0);
+}
+
+void dot_add(NTTBuffers &nb, bool sqr) {
+    size_t n = nb.ntt1.ntt_a.size();
+    nb.ntt1.dot_conv(n, nb.r, sqr);
+    nb.ntt2.dot_conv(n, nb.r, sqr);
+}
+
+void dot_conv(NTTBuffers &nb) {
+    size_t n = nb.ntt1.ntt_s.size();
+    nb.ntt1.ntt_a.swap(nb.ntt1.ntt_s);
+    nb.ntt2.ntt_a.swap(nb.ntt2.ntt_s);
+    nb.ntt1.transform(&nb.ntt1.ntt_a.front(), n, 0, nb.r);
+    nb.ntt2.transform(&nb.ntt2.ntt_a.front(), n, 0, nb.r);
+    double_mod_rev(nb, n);
+}
+
+// convolutions for the users of the engine. an object owns its buffers and tables and shares
+// nothing with the products of the big integers or with the other objects, so an object per thread
+// is enough; a batch reuses the tables. MOD is a prime below 2^29 with the primitive root 3 such as
+// NTT_P1 and NTT_P2. the lanes are 64-bit in every build, the sums of the butterflies are not reduced
+// and stay below 2^34, so their products with the roots fit. a product longer than max_len() is
+// split into pieces of max_len() / 2
+template <int32_t MOD> class ConvMod {
+    typedef char mod_check[MOD > 2 && MOD % 2 == 1 && MOD < (1 << 29) ? 1 : -1];
+    std::vector<int64_t> fa, fb, wn[2];
+    std::vector<size_t> rev;
+
+    static int64_t pow_mod(int64_t a, int64_t b) {
+        int64_t ans = 1;
+        a %= MOD;
+        while (b) {
+            if (b & 1) ans = ans * a % MOD;
+            b >>= 1;
+            a = a * a % MOD;
+        }
+        return ans;
+    }
+    size_t prepare(size_t n) {
+        size_t len = 1;
+        while (len < n)
+            len <<= 1;
+        if (rev.size() != len) {
+            rev.resize(len);
+            for (size_t i = 0; i < len; i++)
+                rev[i] = (rev[i >> 1] >> 1) | ((i & 1) * (len >> 1));
+            int64_t root = pow_mod(NTT_G, (MOD - 1) / (int64_t)len);
+            // the roots of the level of half length h are at [h, 2h)
+            for (int on = 1; on >= 0; --on) {
+                std::vector<int64_t> &w = wn[on];
+                w.resize(len);
+                for (size_t i = 0; i < len / 2; ++i)
+                    w[len / 2 + i] = i ? w[len / 2 + i - 1] * root % MOD : 1;
+                for (size_t h = len / 4; h > 0; h /= 2)
+                    for (size_t i = 0; i < h; ++i)
+                        w[h + i] = w[h * 2 + i * 2];
+                root = pow_mod(root, MOD - 2);
+            }
+        }
+        return len;
+    }
+    static void load(const std::vector<uint32_t> &a, std::vector<int64_t> &t, size_t len) {
+        t.assign(len, 0);
+        for (size_t i = 0; i < a.size(); ++i)
+            t[i] = a[i] % (uint32_t)MOD;
+    }
+    // on = 1 forward, on = 0 inverse, the results are reduced
+    void transform(std::vector<int64_t> &a, int on) {
+        size_t len = a.size();
+        for (size_t i = 0; i < len; i++) {
+            if (i < rev[i]) std::swap(a[i], a[rev[i]]);
+        }
+        for (size_t h = 1; h < len; h <<= 1) {
+            const int64_t *w = &wn[on][h];
+            for (size_t j = 0; j < len; j += h << 1) {
+                for (size_t k = j; k < j + h; k++) {
+                    int64_t t = w[k - j] * a[k + h] % MOD;
+                    a[k + h] = a[k] - t + MOD;
+                    a[k] += t;
+                }
+            }
+        }
+        int64_t inv = on ? 1 : pow_mod((int64_t)len, MOD - 2);
+        for (size_t i = 0; i < len; i++)
+            a[i] = a[i] % MOD * inv % MOD;
+    }
+    void mul_split(const std::vector<uint32_t> &a, const std::vector<uint32_t> &b, std::vector<uint32_t> &r) {
+        size_t h = max_len() / 2;
+        std::vector<uint32_t> x, y, t;
+        r.assign(a.size() + b.size() - 1, 0);
+        for (size_t i = 0; i < a.size(); i += h) {
+            x.assign(a.begin() + i, a.begin() + std::min(a.size(), i + h));
+            for (size_t j = 0; j < b.size(); j += h) {
+                y.assign(b.begin() + j, b.begin() + std::min(b.size(), j + h));
+                mul(x, y, t);
+                for (size_t k = 0; k < t.size(); ++k)
+                    r[i + j + k] = (uint32_t)((r[i + j + k] + t[k]) % (uint32_t)MOD);
+            }
+        }
+    }
+
+public:
+    // the longest product by one transform, the largest power of 2 dividing MOD - 1
+    static size_t max_len() {
+        size_t m = 1;
+        while ((MOD - 1) % (m * 2) == 0)
+            m *= 2;
+        return m;
+    }
+    // r = a * b mod MOD, the coefficients are from the lowest
+    void mul(const std::vector<uint32_t> &a, const std::vector<uint32_t> &b, std::vector<uint32_t> &r) {
+        if (a.empty() || b.empty()) {
+            r.clear();
+            return;
+        }
+        size_t n = a.size() + b.size() - 1;
+        if (n > max_len()) {
+            mul_split(a, b, r);
+            return;
+        }
+        size_t len = prepare(n);
+        load(a, fa, len);
+        transform(fa, 1);
+        if (&a == &b) {
+            for (size_t i = 0; i < len; i++)
+                fa[i] = fa[i] * fa[i] % MOD;
+        } else {
+            load(b, fb, len);
+            transform(fb, 1);
+            for (size_t i = 0; i < len; i++)
+                fa[i] = fa[i] * fb[i] % MOD;
+        }
+        transform(fa, 0);
+        r.resize(n);
+        for (size_t i = 0; i < n; i++)
+            r[i] = (uint32_t)fa[i];
+    }
+    // r[i] = a[i] * b[i] mod MOD
+    void mul(const std::vector<std::vector<uint32_t> > &a, const std::vector<std::vector<uint32_t> > &b,
+             std::vector<std::vector<uint32_t> > &r) {
+        r.resize(std::min(a.size(), b.size()));
+        for (size_t i = 0; i < r.size(); ++i)
+            mul(a[i], b[i], r[i]);
+    }
+};
+
+// exact convolution by the two primes and CRT, the coefficients of a product
+// must be less than NTT_P1 * NTT_P2, about 2^56 (2^53 without BIGINT_X64)
+class ConvExact {
+    ConvMod<NTT_P1> c1;
+    ConvMod<NTT_P2> c2;
+    std::vector<uint32_t> r1, r2;
+
+public:
+    void mul(const std::vector<uint32_t> &a, const std::vector<uint32_t> &b, std::vector<uint64_t> &r) {
+        c1.mul(a, b, r1);
+        c2.mul(a, b, r2);
+        r.resize(r1.size());
+        for (size_t i = 0; i < r.size(); i++) {
+            // the same as double_mod_rev
+            int64_t t = ((int64_t)r1[i] - (int64_t)r2[i]) % NTT_P1 + NTT_P1;
+            r[i] = (uint64_t)(t * NTT_P2_INV % NTT_P1) * NTT_P2 + r2[i];
+        }
+    }
+    void mul(const std::vector<std::vector<uint32_t> > &a, const std::vector<std::vector<uint32_t> > &b,
+             std::vector<std::vector<uint64_t> > &r) {
+        r.resize(std::min(a.size(), b.size()));
+        for (size_t i = 0; i < r.size(); ++i)
+            mul(a[i], b[i], r[i]);
+    }
+};
 } // namespace NTT_NS
+
+namespace POW_NS {
+// plain products, for the powers without modulus
+template <class BigInt_t> struct mul_ctx {
+    BigInt_t one() const { return BigInt_t(1); }
+    BigInt_t mul(const BigInt_t &a, const BigInt_t &b) const { return a * b; }
+    BigInt_t sqr(const BigInt_t &a) const { return a * a; }
+};
+
+// the exponents are stored in 32-bit words from the lowest
+inline uint32_t bit_at(const std::vector<uint32_t> &e, size_t i) { return e[i >> 5] >> (i & 31) & 1; }
+
+inline size_t bit_length(const std::vector<uint32_t> &e) {
+    size_t i = e.size();
+    while (i > 0 && e[i - 1] == 0)
+        --i;
+    if (i == 0) return 0;
+    return (i - 1) * 32 + NTT_NS::log2(e[i - 1]) + 1;
+}
+
+// sliding window exponentiation, ctx provides one(), mul() and sqr()
+template <class Ctx, class BigInt_t> BigInt_t pow_window(const Ctx &ctx, const BigInt_t &g, const std::vector<uint32_t> &e) {
+    static const size_t win_bits[] = {7, 25, 81, 241, 673, 1793};
+    size_t bits = bit_length(e), k = 1;
+    if (bits == 0) return ctx.one();
+    while (k < 7 && bits > win_bits[k - 1])
+        ++k;
+    // g, g^3, g^5, ..., g^(2^k - 1)
+    std::vector<BigInt_t> odd(1, g);
+    if (k > 1) {
+        BigInt_t g2 = ctx.sqr(g);
+        for (size_t i = (size_t)1 << (k - 1); i > 1; --i)
+            odd.push_back(ctx.mul(odd.back(), g2));
+    }
+    BigInt_t r;
+    for (size_t i = bits - 1; i < bits;) {
+        if (!bit_at(e, i)) {
+            r = ctx.sqr(r);
+            --i;
+            continue;
+        }
+        // the longest window not longer than k, which ends with bit 1
+        size_t j = i + 1 > k ? i + 1 - k : 0;
+        while (!bit_at(e, j))
+            ++j;
+        size_t w = 0;
+        for (size_t t = i + 1; t > j; --t)
+            w = w << 1 | bit_at(e, t - 1);
+        if (i + 1 == bits) {
+            r = odd[w >> 1];
+        } else {
+            for (size_t t = j; t <= i; ++t)
+                r = ctx.sqr(r);
+            r = ctx.mul(r, odd[w >> 1]);
+        }
+        i = j - 1;
+    }
+    return r;
+}
+
+// the window size for the fixed base tables, it takes about bits / k + 2^(k + 1) products
+inline size_t fixed_window(size_t bits) {
+    size_t k = 1;
+    while (k < 16 && bits / (k + 1) + ((size_t)2 << (k + 1)) < bits / k + ((size_t)2 << k))
+        ++k;
+    return k;
+}
+
+// table[i] = g^(2^(k * i)), for the exponents less than 2^bits
+template <class Ctx, class BigInt_t>
+void pow_table(const Ctx &ctx, const BigInt_t &g, size_t bits, size_t k, std::vector<BigInt_t> &table) {
+    table.assign(1, g);
+    for (size_t i = k; i < bits; i += k) {
+        BigInt_t t = table.back();
+        for (size_t j = 0; j < k; ++j)
+            t = ctx.sqr(t);
+        table.push_back(t);
+    }
+}
+
+// Yao's method on the table above, no squaring is needed
+template <class Ctx, class BigInt_t>
+BigInt_t pow_fixed(const Ctx &ctx, const std::vector<BigInt_t> &table, size_t k, const std::vector<uint32_t> &e) {
+    size_t bits = bit_length(e);
+    if (bits > table.size() * k) return pow_window(ctx, table[0], e);
+    std::vector<uint32_t> digits((bits + k - 1) / k);
+    for (size_t i = 0; i < bits; ++i)
+        digits[i / k] |= bit_at(e, i) << (i % k);
+    BigInt_t r, a;
+    bool r_one = true, a_one = true;
+    for (uint32_t d = (1u << k) - 1; d > 0; --d) {
+        for (size_t i = 0; i < digits.size(); ++i) {
+            if (digits[i] != d) continue;
+            a = a_one ? table[i] : ctx.mul(a, table[i]);
+            a_one = false;
+        }
+        if (a_one) continue;
+        r = r_one ? a : ctx.mul(r, a);
+        r_one = false;
+    }
+    if (r_one) return ctx.one();
+    return r;
+}
+} // namespace POW_NS
+
+namespace COMB_NS {
+// the primes not greater than n
+inline std::vector<uint32_t> primes(uint32_t n) {
+    std::vector<uint32_t> r;
+    if (n < 2) return r;
+    r.push_back(2);
+    std::vector<char> composite(n / 2 + 1); // only the odd numbers
+    for (uint32_t i = 3; i <= n; i += 2) {
+        if (composite[i / 2]) continue;
+        r.push_back(i);
+        for (uint64_t j = (uint64_t)i * i; j <= n; j += i * 2)
+            composite[j / 2] = 1;
+    }
+    return r;
+}
+
+// small factors are packed into words less than 2^62 before the product tree
+inline void push_factor(std::vector<uint64_t> &f, uint64_t x) {
+    if (!f.empty() && f.back() < ((uint64_t)1 << 31) && x < ((uint64_t)1 << 31))
+        f.back() *= x;
+    else
+        f.push_back(x);
+}
+
+// balanced product tree of the words in [a, b)
+template <class BigInt_t> BigInt_t product(const std::vector<uint64_t> &f, size_t a, size_t b) {
+    if (a == b) return BigInt_t(1);
+    if (b - a == 1) return BigInt_t((intmax_t)f[a]);
+    size_t m = a + (b - a) / 2;
+    return product<BigInt_t>(f, a, m) * product<BigInt_t>(f, m, b);
+}
+
+// the odd part of the prime swing n! / (n / 2)!^2, p^e in it is not greater than n
+template <class BigInt_t> BigInt_t odd_swing(uint32_t n, const std::vector<uint32_t> &pr) {
+    std::vector<uint64_t> f;
+    for (size_t i = 1; i < pr.size() && pr[i] <= n; ++i) {
+        uint64_t x = 1;
+        for (uint32_t q = n / pr[i]; q > 0; q /= pr[i])
+            if (q & 1) x *= pr[i];
+        if (x > 1) push_factor(f, x);
+    }
+    return product<BigInt_t>(f, 0, f.size());
+}
+
+// the odd part of n!, n! = (n / 2)!^2 * swing(n)
+template <class BigInt_t> BigInt_t odd_factorial(uint32_t n, const std::vector<uint32_t> &pr) {
+    if (n < 3) return BigInt_t(1);
+    BigInt_t r = odd_factorial<BigInt_t>(n / 2, pr);
+    return r * r * odd_swing<BigInt_t>(n, pr);
+}
+
+// the exponent of 2 in n!
+inline uint64_t factorial_twos(uint32_t n) {
+    uint64_t r = 0;
+    for (n /= 2; n > 0; n /= 2)
+        r += n;
+    return r;
+}
+
+// the odd part of n! / (k! (n - k)!), the exponent of 2 is stored in twos
+// the exponent of p is the number of borrows in n - k in base p
+template <class BigInt_t> BigInt_t odd_binomial(uint32_t n, uint32_t k, uint64_t &twos) {
+    std::vector<uint32_t> pr = primes(n);
+    std::vector<uint64_t> f;
+    twos = 0;
+    for (size_t i = 0; i < pr.size(); ++i) {
+        uint32_t e = 0;
+        for (uint64_t q = pr[i]; q <= n; q *= pr[i])
+            e += (uint32_t)(n / q - k / q - (n - k) / q);
+        if (i == 0) {
+            twos = e;
+        } else if (e > 0) {
+            uint64_t x = 1;
+            while (e--)
+                x *= pr[i];
+            push_factor(f, x);
+        }
+    }
+    return product<BigInt_t>(f, 0, f.size());
+}
+
+template <class BigInt_t> BigInt_t primorial(uint32_t n) {
+    std::vector<uint32_t> pr = primes(n);
+    std::vector<uint64_t> f;
+    for (size_t i = 0; i < pr.size(); ++i)
+        push_factor(f, pr[i]);
+    return product<BigInt_t>(f, 0, f.size());
+}
+} // namespace COMB_NS
+
+// expression templates, lazy(a) * b + c * d - e is kept as a tree and evaluated on assignment.
+// sums go into the destination in place and products use addmul/submul.
+// the tree holds references, so it must be assigned in the same full expression
+namespace EXPR_NS {
+template <class E> struct Expr {
+    const E &self() const { return static_cast<const E &>(*this); }
+};
+
+template <class T> struct Ref : Expr<Ref<T> > {
+    typedef T value_type;
+    enum { has_mul = 0 };
+    const T *p;
+    explicit Ref(const T &a) : p(&a) {}
+    bool refers(const T *r) const { return p == r; }
+    // r = sgn * value
+    void assign(T &r, int sgn) const {
+        r = *p;
+        if (sgn < 0 && !r.is_zero()) r.inv();
+    }
+    // r += sgn * value
+    void accumulate(T &r, int sgn) const {
+        if (sgn > 0)
+            r += *p;
+        else
+            r -= *p;
+    }
+    const T &value(T &) const { return *p; }
+};
+
+template <class L, class R> struct Mul : Expr<Mul<L, R> > {
+    typedef typename L::value_type value_type;
+    typedef value_type T;
+    enum { has_mul = 1 };
+    L l;
+    R r;
+    Mul(const L &l, const R &r) : l(l), r(r) {}
+    bool refers(const T *t) const { return l.refers(t) || r.refers(t); }
+    // the product goes into the buffer of d
+    void assign(T &d, int sgn) const {
+        d.set(0);
+        accumulate(d, sgn);
+    }
+    void accumulate(T &d, int sgn) const {
+        T x, y;
+        if (sgn > 0)
+            d.addmul(l.value(x), r.value(y));
+        else
+            d.submul(l.value(x), r.value(y));
+    }
+    const T &value(T &t) const {
+        assign(t, 1);
+        return t;
+    }
+};
+
+// l + S * r
+template <class L, class R, int S> struct Sum : Expr<Sum<L, R, S> > {
+    typedef typename L::value_type value_type;
+    typedef value_type T;
+    enum { has_mul = L::has_mul || R::has_mul };
+    L l;
+    R r;
+    Sum(const L &l, const R &r) : l(l), r(r) {}
+    bool refers(const T *t) const { return l.refers(t) || r.refers(t); }
+    void assign(T &d, int sgn) const {
+        // start from a product so that it is built in d, the rest is added in place
+        if (!L::has_mul && R::has_mul) {
+            r.assign(d, sgn * S);
+            l.accumulate(d, sgn);
+        } else {
+            l.assign(d, sgn);
+            r.accumulate(d, sgn * S);
+        }
+    }
+    void accumulate(T &d, int sgn) const {
+        l.accumulate(d, sgn);
+        r.accumulate(d, sgn * S);
+    }
+    const T &value(T &t) const {
+        assign(t, 1);
+        return t;
+    }
+};
+
+// mode 0 for r = e, 1 for r += e, -1 for r -= e
+template <class T, class E> T &assign(T &r, const E &e, int mode) {
+    if (e.refers(&r)) {
+        T t;
+        e.assign(t, 1);
+        if (mode == 0)
+            r = BIGINT_STD_MOVE(t);
+        else if (mode > 0)
+            r += t;
+        else
+            r -= t;
+    } else if (mode == 0) {
+        e.assign(r, 1);
+    } else {
+        e.accumulate(r, mode);
+    }
+    return r;
+}
+
+template <class L, class R> Sum<L, R, 1> operator+(const Expr<L> &a, const Expr<R> &b) {
+    return Sum<L, R, 1>(a.self(), b.self());
+}
+template <class L> Sum<L, Ref<typename L::value_type>, 1> operator+(const Expr<L> &a, const typename L::value_type &b) {
+    return Sum<L, Ref<typename L::value_type>, 1>(a.self(), Ref<typename L::value_type>(b));
+}
+template <class R> Sum<Ref<typename R::value_type>, R, 1> operator+(const typename R::value_type &a, const Expr<R> &b) {
+    return Sum<Ref<typename R::value_type>, R, 1>(Ref<typename R::value_type>(a), b.self());
+}
+template <class L, class R> Sum<L, R, -1> operator-(const Expr<L> &a, const Expr<R> &b) {
+    return Sum<L, R, -1>(a.self(), b.self());
+}
+template <class L> Sum<L, Ref<typename L::value_type>, -1> operator-(const Expr<L> &a, const typename L::value_type &b) {
+    return Sum<L, Ref<typename L::value_type>, -1>(a.self(), Ref<typename L::value_type>(b));
+}
+template <class R> Sum<Ref<typename R::value_type>, R, -1> operator-(const typename R::value_type &a, const Expr<R> &b) {
+    return Sum<Ref<typename R::value_type>, R, -1>(Ref<typename R::value_type>(a), b.self());
+}
+template <class L, class R> Mul<L, R> operator*(const Expr<L> &a, const Expr<R> &b) {
+    return Mul<L, R>(a.self(), b.self());
+}
+template <class L> Mul<L, Ref<typename L::value_type> > operator*(const Expr<L> &a, const typename L::value_type &b) {
+    return Mul<L, Ref<typename L::value_type> >(a.self(), Ref<typename L::value_type>(b));
+}
+template <class R> Mul<Ref<typename R::value_type>, R> operator*(const typename R::value_type &a, const Expr<R> &b) {
+    return Mul<Ref<typename R::value_type>, R>(Ref<typename R::value_type>(a), b.self());
+}
+} // namespace EXPR_NS
 //{hexm_e}{decm_e}
 
 namespace BigIntBaseNS {
@@ -284,14 +833,14 @@ struct BigIntBase {
         BigInt_t r(base, digits);
         if (n >= size()) return r;
         r.v.assign(v.begin() + n, v.end());
-        return BIGINT_STD_MOVE(r);
+        return r;
     }
     BigInt_t raw_lowdigits_to(size_t n) const {
         if (n >= size()) return *this;
         BigInt_t r(base, digits);
         r.v.assign(v.begin(), v.begin() + n);
         r.trim();
-        return BIGINT_STD_MOVE(r);
+        return r;
     }
     BigInt_t &raw_shl(size_t n) {
         if (n == 0 || (size() == 1 && v[0] == 0)) return *this;
@@ -346,16 +895,17 @@ struct BigIntBase {
         if (std::min(a.size(), b.size()) <= BIGINT_NTT_THRESHOLD || (a.size() + b.size()) > NTT_MAX_SIZE)
             return raw_mul_karatsuba(a, b);
         size_t len, lenmul = 1;
-        std::vector<NTT_NS::ntt_base_t> &ntt_a = NTT_NS::ntt1.ntt_a, &ntt_b = NTT_NS::ntt1.ntt_b;
-        std::vector<int64_t> &ntt_c = NTT_NS::ntt1.ntt_c;
+        NTT_NS::NTTBuffers &nb = NTT_NS::ntt_buffers;
+        std::vector<NTT_NS::ntt_base_t> &ntt_a = nb.ntt1.ntt_a, &ntt_b = nb.ntt1.ntt_b;
+        std::vector<int64_t> &ntt_c = nb.ntt1.ntt_c;
         ntt_a.resize(a.size());
         ntt_b.resize(b.size());
         for (size_t i = 0; i < a.size(); ++i)
             ntt_a[i] = a.v[i];
         for (size_t i = 0; i < b.size(); ++i)
             ntt_b[i] = b.v[i];
-        NTT_NS::ntt_prepare(a.size(), b.size(), len, 7);
-        NTT_NS::mul_conv();
+        NTT_NS::ntt_prepare(nb, a.size(), b.size(), len, 7);
+        NTT_NS::mul_conv(nb);
         len = (a.size() + b.size()) * lenmul;
         while (len > 0 && ntt_c[--len] == 0)
             ;
@@ -375,13 +925,14 @@ struct BigIntBase {
         if (a.size() <= BIGINT_MUL_THRESHOLD) return raw_mul(a, a);
         if (a.size() <= BIGINT_NTT_THRESHOLD || (a.size() + a.size()) > NTT_MAX_SIZE) return raw_mul_karatsuba(a, a);
         size_t len, lenmul = 1;
-        std::vector<NTT_NS::ntt_base_t> &ntt_a = NTT_NS::ntt1.ntt_a;
-        std::vector<int64_t> &ntt_c = NTT_NS::ntt1.ntt_c;
+        NTT_NS::NTTBuffers &nb = NTT_NS::ntt_buffers;
+        std::vector<NTT_NS::ntt_base_t> &ntt_a = nb.ntt1.ntt_a;
+        std::vector<int64_t> &ntt_c = nb.ntt1.ntt_c;
         ntt_a.resize(a.size());
         for (size_t i = 0; i < a.size(); ++i)
             ntt_a[i] = a.v[i];
-        NTT_NS::ntt_prepare(a.size() * 2, 0, len, 2);
-        NTT_NS::sqr_conv();
+        NTT_NS::ntt_prepare(nb, a.size() * 2, 0, len, 2);
+        NTT_NS::sqr_conv(nb);
         len = (a.size() + a.size()) * lenmul;
         while (len > 0 && ntt_c[--len] == 0)
             ;
@@ -32,9 +32,17 @@ template <typename T> inline T high_digit(T digit) { return digit / (T)COMPRESS_
 
 template <typename T> inline uint32_t low_digit(T digit) { return (uint32_t)(digit % (T)COMPRESS_MOD); }
 
+// column sums of the schoolbook product
+static BIGINT_THREAD_LOCAL std::vector<uint64_t> mul_cols;
+
+class BigIntDecBarrett;
+class BigIntDecPowTable;
+class BigIntDecAccum;
+
 class BigIntDec {
 protected:
     typedef uint32_t base_t;
+    typedef BigIntLimbView<base_t> view_t;
 #if BIGINT_LARGE_BASE
     typedef int64_t carry_t;
     typedef uint64_t ucarry_t;
@@ -43,8 +51,14 @@ protected:
     typedef uint32_t ucarry_t;
 #endif
     int sign;
-    std::vector<base_t> v;
+    BigIntLimbs<base_t, BIGINT_INLINE_LIMBS> v;
     typedef BigIntDec BigInt_t;
+    friend class BigIntDecBarrett;
+    friend class BigIntDecPowTable;
+    friend class BigIntDecAccum;
+    friend BigInt_t isqrt_rem(const BigInt_t &a, BigInt_t &r);
+    friend BigInt_t iroot(const BigInt_t &a, uint32_t k);
+    friend BigInt_t dot(const std::vector<BigInt_t> &a, const std::vector<BigInt_t> &b);
     template <typename _Tx, typename _Ty> static inline void carry(_Tx &add, _Ty &baseval, _Tx newval) {
         add += newval;
         baseval = low_digit(add);
@@ -55,7 +69,26 @@ protected:
         baseval = (_Tx)low_digit(add) + COMPRESS_MOD - 1;
         add = high_digit(add);
     }
+    // carry and borrow for a sum of two limbs, the carry is at most 1 so compares replace the division.
+    // the carry out is found from newval, only the and/or with the carry in is a serial dependency
+    template <typename _Tx, typename _Ty> static inline void carry1(_Tx &add, _Ty &baseval, _Tx newval) {
+        _Tx c = (newval >= (_Tx)COMPRESS_MOD) | ((newval == (_Tx)COMPRESS_MOD - 1) & add);
+        baseval = (_Ty)(newval + add - ((_Tx)COMPRESS_MOD & (0 - c)));
+        add = c;
+    }
+    template <typename _Tx, typename _Ty> static inline void borrow1(_Tx &add, _Ty &baseval, _Tx newval) {
+        _Tx c = (newval < 0) | ((newval == 0) & -add);
+        baseval = (_Ty)(newval + add + ((_Tx)COMPRESS_MOD & (0 - c)));
+        add = -c;
+    }
 
+    operator view_t() const { return raw_view(); }
+    view_t raw_view() const { return view_t(&v[0], size(), sign); }
+    BigInt_t &raw_assign(const view_t &a) {
+        v.assign(a.v, a.v + a.size());
+        sign = a.sign;
+        return *this;
+    }
     bool raw_less(const BigInt_t &b) const {
         if (v.size() != b.size()) return v.size() < b.size();
         for (size_t i = v.size() - 1; i < v.size(); i--)
@@ -69,42 +102,47 @@ protected:
             if (v[i] != b.v[i]) return false;
         return true;
     }
-    BigInt_t &raw_add(const BigInt_t &b) {
+    BigInt_t &raw_add(const view_t &b) {
+        v.unshare();
         if (v.size() < b.size()) v.resize(b.size());
         ucarry_t add = 0;
-        for (size_t i = 0; i < b.v.size(); i++)
-            carry(add, v[i], (ucarry_t)(v[i] + b.v[i]));
-        for (size_t i = b.v.size(); add && i < v.size(); i++)
-            carry(add, v[i], (ucarry_t)v[i]);
+        for (size_t i = 0; i < b.size(); i++)
+            carry1(add, v[i], (ucarry_t)(v[i] + b.v[i]));
+        for (size_t i = b.size(); add && i < v.size(); i++)
+            carry1(add, v[i], (ucarry_t)v[i]);
         add ? v.push_back((base_t)add) : trim();
         return *this;
     }
     BigInt_t &raw_offset_add(const BigInt_t &b, size_t offset) {
+        v.unshare();
         ucarry_t add = 0;
         for (size_t i = 0; i < b.size(); ++i)
-            carry(add, v[i + offset], (ucarry_t)(v[i + offset] + b.v[i]));
+            carry1(add, v[i + offset], (ucarry_t)(v[i + offset] + b.v[i]));
         for (size_t i = b.size() + offset; add; ++i)
-            carry(add, v[i], (ucarry_t)v[i]);
+            carry1(add, v[i], (ucarry_t)v[i]);
         return *this;
     }
     BigInt_t &raw_sub(const BigInt_t &b) {
+        v.unshare();
         if (v.size() < b.v.size()) v.resize(b.v.size());
         carry_t add = 0;
         for (size_t i = 0; i < b.v.size(); i++)
-            borrow(add, v[i], (carry_t)v[i] - (carry_t)b.v[i]);
+            borrow1(add, v[i], (carry_t)v[i] - (carry_t)b.v[i]);
         for (size_t i = b.v.size(); add && i < v.size(); i++)
-            borrow(add, v[i], (carry_t)v[i]);
+            borrow1(add, v[i], (carry_t)v[i]);
         if (add) {
             sign = -sign;
             add = 1;
             for (size_t i = 0; i < v.size(); i++)
-                carry(add, v[i], (carry_t)(COMPRESS_MOD - v[i] - 1));
+                carry1(add, v[i], (carry_t)(COMPRESS_MOD - v[i] - 1));
         }
         trim();
+        if (is_zero()) sign = 1;
         return *this;
     }
     BigInt_t &raw_offset_mulsub(const BigInt_t &b, base_t mul, size_t offset) {
         if (mul == 0) return *this;
+        v.unshare();
         carry_t add = 0;
         for (size_t i = 0; i < b.v.size(); i++)
             borrow(add, v[i + offset], (carry_t)v[i + offset] - (carry_t)b.v[i] * (carry_t)mul);
@@ -112,12 +150,23 @@ protected:
             borrow(add, v[i], (carry_t)v[i]);
         return *this;
     }
+    // normalises n column sums into limbs below COMPRESS_MOD, returns the carry out of the top column
+    static uint64_t raw_normalize(uint64_t *c, size_t n) {
+        uint64_t add = 0;
+        for (size_t i = 0; i < n; ++i) {
+            add += c[i];
+            c[i] = low_digit(add);
+            add = high_digit(add);
+        }
+        return add;
+    }
     BigInt_t &raw_mul_int(base_t m) {
         if (m == 0) {
             set(0);
             return *this;
         } else if (m == 1)
             return *this;
+        v.unshare();
         ucarry_t add = 0;
         size_t i = 0;
         for (; i + 4 <= v.size(); i += 4) {
@@ -135,73 +184,108 @@ protected:
         if (add) v.push_back((base_t)add);
         return *this;
     }
-    BigInt_t &raw_mul(const BigInt_t &a, const BigInt_t &b) {
+    BigInt_t &raw_mul(const view_t &a, const view_t &b) { return raw_mul(a, b, mul_cols); }
+    // cols is the buffer of the column sums, looked up once per product by the caller
+    BigInt_t &raw_mul(const view_t &a, const view_t &b, std::vector<uint64_t> &cols) {
         if (a.is_zero() || b.is_zero()) {
             return set(0);
         }
         if (a.size() == 1 && a.v[0] == 1) {
-            *this = b;
+            raw_assign(b);
             sign *= a.sign;
             return *this;
         }
         if (b.size() == 1 && b.v[0] == 1) {
-            *this = a;
+            raw_assign(a);
             sign *= b.sign;
             return *this;
         }
         if (a.size() == 2 && a.v[1] == 1 && a.v[0] == 0) {
-            *this = b;
+            raw_assign(b);
             raw_shl(1);
             sign *= a.sign;
             return *this;
         }
         if (b.size() == 2 && b.v[1] == 1 && b.v[0] == 0) {
-            *this = a;
+            raw_assign(a);
             raw_shl(1);
             sign *= b.sign;
             return *this;
         }
-        v.clear();
-        v.resize(a.size() + b.size());
-        for (size_t i = 0; i < a.size(); i++) {
-            ucarry_t add = 0, av = a.v[i];
-            size_t j = 0;
-            for (; j + 4 <= b.size(); j += 4) {
-                carry(add, v[i + j], v[i + j] + av * b.v[j]);
-                carry(add, v[i + j + 1], v[i + j + 1] + av * b.v[j + 1]);
-                carry(add, v[i + j + 2], v[i + j + 2] + av * b.v[j + 2]);
-                carry(add, v[i + j + 3], v[i + j + 3] + av * b.v[j + 3]);
-                // carry(add, v[i + j + 4], v[i + j + 4] + av * b.v[j + 4]);
-                // carry(add, v[i + j + 5], v[i + j + 5] + av * b.v[j + 5]);
-                // carry(add, v[i + j + 6], v[i + j + 6] + av * b.v[j + 6]);
-                // carry(add, v[i + j + 7], v[i + j + 7] + av * b.v[j + 7]);
+        // the rows are summed into 64 bit columns without carrying, and the columns are
+        // normalised once per block of rows, before a column can overflow. the limbs and the sizes
+        // are copied to locals, a size_t may alias the columns and the loop would not be vectorized
+        const view_t &x = a.size() < b.size() ? a : b, &y = a.size() < b.size() ? b : a;
+        const size_t block = (size_t)(~(uint64_t)0 / ((uint64_t)COMPRESS_MOD * COMPRESS_MOD) - 1);
+        const base_t *xp = x.v, *yp = y.v;
+        const size_t nx = x.size(), ny = y.size(), n = nx + ny;
+        cols.assign(n, 0);
+        uint64_t *c = &cols[0];
+        for (size_t i = 0; i < nx;) {
+            for (size_t e = std::min(nx, i + block); i < e; i++) {
+                uint64_t xv = xp[i], *ci = c + i;
+                for (size_t j = 0; j < ny; ++j)
+                    ci[j] += xv * yp[j];
             }
-            for (; j < b.size(); ++j) {
-                carry(add, v[i + j], v[i + j] + av * b.v[j]);
-            }
-            v[i + b.size()] += (base_t)add;
+            raw_normalize(c, n);
+        }
+        v.resize(n);
+        for (size_t i = 0; i < n; ++i)
+            v[i] = (base_t)c[i];
+        trim();
+        return *this;
+    }
+    // adds |a| * |b| to the magnitude, the schoolbook rows go straight into the limbs
+    BigInt_t &raw_muladd(const BigInt_t &a, const BigInt_t &b) {
+        const BigInt_t &x = a.size() < b.size() ? a : b, &y = a.size() < b.size() ? b : a;
+        v.resize(std::max(size(), x.size() + y.size()) + 1);
+        for (size_t i = 0; i < x.size(); i++) {
+            ucarry_t add = 0, xv = x.v[i];
+            if (xv == 0) continue;
+            for (size_t j = 0; j < y.size(); ++j)
+                carry(add, v[i + j], v[i + j] + xv * y.v[j]);
+            for (size_t j = i + y.size(); add; ++j)
+                carry(add, v[j], (ucarry_t)v[j]);
         }
         trim();
         return *this;
     }
+    // *this += s * a * b
+    BigInt_t &raw_addmul(const BigInt_t &a, const BigInt_t &b, int s) {
+        if (a.is_zero() || b.is_zero()) return *this;
+        int ps = a.sign * b.sign * s;
+        if (this != &a && this != &b && (is_zero() || sign == ps) &&
+            (a.size() == 1 || b.size() == 1 || a.size() + b.size() <= BIGINT_MUL_THRESHOLD * 2)) {
+            if (is_zero()) sign = ps;
+            return raw_muladd(a, b);
+        }
+        BigInt_t t = a * b;
+        if (is_zero()) {
+            v.swap(t.v);
+            sign = ps;
+            return *this;
+        }
+        return s > 0 ? *this += t : *this -= t;
+    }
     // Karatsuba algorithm
-    BigInt_t &raw_mul_karatsuba(const BigInt_t &a, const BigInt_t &b) {
+    BigInt_t &raw_mul_karatsuba(const view_t &a, const view_t &b) { return raw_mul_karatsuba(a, b, mul_cols); }
+    BigInt_t &raw_mul_karatsuba(const view_t &a, const view_t &b, std::vector<uint64_t> &cols) {
         if (std::min(a.size(), b.size()) <= BIGINT_MUL_THRESHOLD) {
-            return raw_mul(a, b);
+            return raw_mul(a, b, cols);
         }
         if (a.size() * 2 < b.size() || b.size() * 2 < a.size()) { // split
             BigInt_t t;
             if (a.size() < b.size()) {
                 size_t split = b.size() / 2;
-                t.raw_mul_karatsuba(a, b.raw_shr_to(split));
+                t.raw_mul_karatsuba(a, b.shr(split), cols);
                 t.raw_shl(split);
-                raw_mul_karatsuba(a, b.raw_lowdigits_to(split));
+                raw_mul_karatsuba(a, b.low(split), cols);
                 raw_add(t);
             } else {
                 size_t split = a.size() / 2;
-                t.raw_mul_karatsuba(b, a.raw_shr_to(split));
+                t.raw_mul_karatsuba(b, a.shr(split), cols);
                 t.raw_shl(split);
-                raw_mul_karatsuba(b, a.raw_lowdigits_to(split));
+                raw_mul_karatsuba(b, a.low(split), cols);
                 raw_add(t);
             }
             return *this;
@@ -210,16 +294,15 @@ protected:
             ;
         else if ((a.size() + b.size()) <= NTT_MAX_SIZE)
             return raw_nttmul(a, b);
-        BigInt_t ah, al, bh, bl, h, m;
+        BigInt_t h, m, sa, sb;
         size_t split = std::max(std::min((a.size() + 1) / 2, b.size() - 1), std::min(a.size() - 1, (b.size() + 1) / 2));
-        al.v.assign(a.v.begin(), a.v.begin() + split);
-        ah.v.assign(a.v.begin() + split, a.v.end());
-        bl.v.assign(b.v.begin(), b.v.begin() + split);
-        bh.v.assign(b.v.begin() + split, b.v.end());
-
-        raw_mul_karatsuba(al, bl);
-        h.raw_mul_karatsuba(ah, bh);
-        m.raw_mul_karatsuba(al + ah, bl + bh);
+        view_t al = a.low(split), ah = a.shr(split), bl = b.low(split), bh = b.shr(split);
+
+        raw_mul_karatsuba(al, bl, cols);
+        h.raw_mul_karatsuba(ah, bh, cols);
+        sa.raw_assign(al).raw_add(ah);
+        sb.raw_assign(bl).raw_add(bh);
+        m.raw_mul_karatsuba(sa, sb, cols);
         m.raw_sub(*this);
         m.raw_sub(h);
         v.resize(a.size() + b.size());
@@ -229,7 +312,7 @@ protected:
         trim();
         return *this;
     }
-    BigInt_t &raw_nttmul(const BigInt_t &a, const BigInt_t &b) {
+    BigInt_t &raw_nttmul(const view_t &a, const view_t &b) {
         if (std::min(a.size(), b.size()) <= BIGINT_MUL_THRESHOLD) {
             return raw_mul(a, b);
         }
@@ -240,22 +323,23 @@ protected:
             BigInt_t t;
             if (a.size() < b.size()) {
                 size_t split = b.size() / 2;
-                t.raw_nttmul(a, b.raw_shr_to(split));
+                t.raw_nttmul(a, b.shr(split));
                 t.raw_shl(split);
-                raw_nttmul(a, b.raw_lowdigits_to(split));
+                raw_nttmul(a, b.low(split));
                 raw_add(t);
             } else {
                 size_t split = a.size() / 2;
-                t.raw_nttmul(b, a.raw_shr_to(split));
+                t.raw_nttmul(b, a.shr(split));
                 t.raw_shl(split);
-                raw_nttmul(b, a.raw_lowdigits_to(split));
+                raw_nttmul(b, a.low(split));
                 raw_add(t);
             }
             return *this;
         }
         size_t len;
-        std::vector<NTT_NS::ntt_base_t> &ntt_a = NTT_NS::ntt1.ntt_a, &ntt_b = NTT_NS::ntt1.ntt_b;
-        std::vector<int64_t> &ntt_c = NTT_NS::ntt1.ntt_c;
+        NTT_NS::NTTBuffers &nb = NTT_NS::ntt_buffers;
+        std::vector<NTT_NS::ntt_base_t> &ntt_a = nb.ntt1.ntt_a, &ntt_b = nb.ntt1.ntt_b;
+        std::vector<int64_t> &ntt_c = nb.ntt1.ntt_c;
 #if BIGINT_LARGE_BASE
         ntt_a.resize(a.size() * 2);
         ntt_b.resize(b.size() * 2);
@@ -264,16 +348,16 @@ protected:
             ntt_a[++j] = a.v[i] / COMPRESS_HALF_MOD;
         }
         if (a == b) {
-            NTT_NS::ntt_prepare(a.size() * 2, a.size() * 2, len, 7);
-            NTT_NS::sqr_conv();
+            NTT_NS::ntt_prepare(nb, a.size() * 2, a.size() * 2, len, 7);
+            NTT_NS::sqr_conv(nb);
             len = a.size() * 4;
         } else {
             for (size_t i = 0, j = 0; i < b.size(); ++i, ++j) {
                 ntt_b[j] = b.v[i] % COMPRESS_HALF_MOD;
                 ntt_b[++j] = b.v[i] / COMPRESS_HALF_MOD;
             }
-            NTT_NS::ntt_prepare(a.size() * 2, b.size() * 2, len, 7);
-            NTT_NS::mul_conv();
+            NTT_NS::ntt_prepare(nb, a.size() * 2, b.size() * 2, len, 7);
+            NTT_NS::mul_conv(nb);
             len = (a.size() + b.size()) * 2;
         }
 #else
@@ -283,15 +367,15 @@ protected:
             ntt_a[i] = a.v[i];
         }
         if (a == b) {
-            NTT_NS::ntt_prepare(a.size(), a.size(), len, 7);
-            NTT_NS::sqr_conv();
+            NTT_NS::ntt_prepare(nb, a.size(), a.size(), len, 7);
+            NTT_NS::sqr_conv(nb);
             len = a.size() * 2;
         } else {
             for (size_t i = 0; i < b.size(); ++i) {
                 ntt_b[i] = b.v[i];
             }
-            NTT_NS::ntt_prepare(a.size(), b.size(), len, 7);
-            NTT_NS::mul_conv();
+            NTT_NS::ntt_prepare(nb, a.size(), b.size(), len, 7);
+            NTT_NS::mul_conv(nb);
             len = a.size() + b.size();
         }
 #endif
@@ -319,6 +403,177 @@ protected:
         trim();
         return *this;
     }
+    // *this = a[0] * b[0] + a[1] * b[1] + ..., the large products with the same sign and transform length
+    // are summed in the transform domain, so that a group needs only one inverse transform and carry pass
+    BigInt_t &raw_dot(const std::vector<BigInt_t> &a, const std::vector<BigInt_t> &b) {
+#if BIGINT_LARGE_BASE
+        const size_t split = 2; // a limb is two coefficients
+        const uint64_t coef = COMPRESS_HALF_MOD - 1;
+#else
+        const size_t split = 1;
+        const uint64_t coef = COMPRESS_MOD - 1;
+#endif
+        std::vector<std::pair<size_t, size_t> > group[2]; // the transform length and the index, by sign
+        BigInt_t sum[2], t;
+        for (size_t i = 0; i < std::min(a.size(), b.size()); ++i) {
+            const BigInt_t &x = a[i], &y = b[i];
+            if (x.is_zero() || y.is_zero()) continue;
+            int s = x.sign != y.sign;
+            if (std::min(x.size(), y.size()) <= BIGINT_NTT_THRESHOLD || x.size() + y.size() > NTT_MAX_SIZE) {
+                t.raw_nttmul(x, y);
+                sum[s].raw_add(t);
+                continue;
+            }
+            size_t len = 1;
+            while (len < (x.size() + y.size()) * split)
+                len <<= 1;
+            group[s].push_back(std::make_pair(len, i));
+        }
+        // a column of a product is a sum of at most min(x.size(), y.size()) * split terms
+        const uint64_t limit = (uint64_t)NTT_NS::NTT_P1 * NTT_NS::NTT_P2, term = coef * coef * split;
+        NTT_NS::NTTBuffers &nb = NTT_NS::ntt_buffers;
+        std::vector<NTT_NS::ntt_base_t> &ntt_a = nb.ntt1.ntt_a, &ntt_b = nb.ntt1.ntt_b;
+        std::vector<int64_t> &ntt_c = nb.ntt1.ntt_c;
+        for (int s = 0; s < 2; ++s) {
+            std::sort(group[s].begin(), group[s].end());
+            for (size_t j = 0; j < group[s].size();) {
+                size_t len = group[s][j].first;
+                uint64_t bound = 0;
+                NTT_NS::dot_prepare(nb, len);
+                for (; j < group[s].size() && group[s][j].first == len; ++j) {
+                    const BigInt_t &x = a[group[s][j].second], &y = b[group[s][j].second];
+                    uint64_t col = term * std::min(x.size(), y.size());
+                    if (bound > limit - col) break;
+                    bound += col;
+                    bool sqr = x.raw_view() == y.raw_view();
+#if BIGINT_LARGE_BASE
+                    ntt_a.resize(x.size() * 2);
+                    for (size_t i = 0, k = 0; i < x.size(); ++i, ++k) {
+                        ntt_a[k] = x.v[i] % COMPRESS_HALF_MOD;
+                        ntt_a[++k] = x.v[i] / COMPRESS_HALF_MOD;
+                    }
+                    if (!sqr) {
+                        ntt_b.resize(y.size() * 2);
+                        for (size_t i = 0, k = 0; i < y.size(); ++i, ++k) {
+                            ntt_b[k] = y.v[i] % COMPRESS_HALF_MOD;
+                            ntt_b[++k] = y.v[i] / COMPRESS_HALF_MOD;
+                        }
+                    }
+#else
+                    ntt_a.assign(x.v.begin(), x.v.end());
+                    if (!sqr) ntt_b.assign(y.v.begin(), y.v.end());
+#endif
+                    NTT_NS::ntt_prepare_cyclic(nb, len, sqr ? 2 : 7);
+                    NTT_NS::dot_add(nb, sqr);
+                }
+                NTT_NS::dot_conv(nb);
+                t.v.resize(len / split + 1);
+                uint64_t add = 0;
+                for (size_t i = 0; i < len; i += split) {
+#if BIGINT_LARGE_BASE
+                    add += ntt_c[i] + ntt_c[i + 1] * COMPRESS_HALF_MOD;
+#else
+                    add += ntt_c[i];
+#endif
+                    t.v[i / split] = low_digit(add);
+                    add = high_digit(add);
+                }
+                t.v.back() = (base_t)add;
+                t.trim();
+                sum[s].raw_add(t);
+            }
+        }
+        *this = sum[0];
+        return raw_sub(sum[1]);
+    }
+    // wrap-around product, *this = a * b mod (COMPRESS_MOD^n - 1)
+    // it only needs a cyclic convolution of length n, so n should be a power of 2
+    BigInt_t &raw_nttmul_wrap(const BigInt_t &a, const BigInt_t &b, size_t n) {
+        if (std::min(a.size(), b.size()) <= BIGINT_NTT_THRESHOLD || n * 2 > NTT_MAX_SIZE || (n & (n - 1))) {
+            raw_nttmul(a, b);
+            while (size() > n) {
+                BigInt_t h = raw_shr_to(n);
+                v.resize(n);
+                trim();
+                raw_add(h);
+            }
+            return *this;
+        }
+        NTT_NS::NTTBuffers &nb = NTT_NS::ntt_buffers;
+        std::vector<NTT_NS::ntt_base_t> &ntt_a = nb.ntt1.ntt_a, &ntt_b = nb.ntt1.ntt_b;
+        std::vector<int64_t> &ntt_c = nb.ntt1.ntt_c;
+        uint64_t add = 0;
+        v.resize(n);
+#if BIGINT_LARGE_BASE
+        ntt_a.resize(a.size() * 2);
+        ntt_b.resize(b.size() * 2);
+        for (size_t i = 0, j = 0; i < a.size(); ++i, ++j) {
+            ntt_a[j] = a.v[i] % COMPRESS_HALF_MOD;
+            ntt_a[++j] = a.v[i] / COMPRESS_HALF_MOD;
+        }
+        for (size_t i = 0, j = 0; i < b.size(); ++i, ++j) {
+            ntt_b[j] = b.v[i] % COMPRESS_HALF_MOD;
+            ntt_b[++j] = b.v[i] / COMPRESS_HALF_MOD;
+        }
+        NTT_NS::ntt_prepare_cyclic(nb, n * 2, 7);
+        NTT_NS::mul_conv(nb);
+        for (size_t i = 0; i < n; ++i) {
+            add += ntt_c[i * 2] + (ntt_c[i * 2 + 1] * COMPRESS_HALF_MOD);
+            v[i] = low_digit(add);
+            add = high_digit(add);
+        }
+#else
+        ntt_a.resize(a.size());
+        ntt_b.resize(b.size());
+        for (size_t i = 0; i < a.size(); ++i)
+            ntt_a[i] = a.v[i];
+        for (size_t i = 0; i < b.size(); ++i)
+            ntt_b[i] = b.v[i];
+        NTT_NS::ntt_prepare_cyclic(nb, n, 7);
+        NTT_NS::mul_conv(nb);
+        for (size_t i = 0; i < n; ++i) {
+            add += ntt_c[i];
+            v[i] = low_digit(add);
+            add = high_digit(add);
+        }
+#endif
+        // COMPRESS_MOD^n = 1, the carry goes around to the lowest limb
+        for (size_t i = 0; add; i = (i + 1) % n)
+            carry(add, v[i], (uint64_t)v[i]);
+        trim();
+        return *this;
+    }
+    // short product, *this = a * b / COMPRESS_MOD^n, the low columns are skipped
+    // so the result may be 1 less than the exact one
+    BigInt_t &raw_mul_high(const BigInt_t &a, const BigInt_t &b, size_t n) {
+        const BigInt_t &x = a.size() < b.size() ? b : a, &y = a.size() < b.size() ? a : b;
+        if (n >= x.size() + y.size()) return set(0);
+        if (y.size() <= BIGINT_MUL_THRESHOLD) {
+            // keep 2 guard columns, the dropped ones are less than y.size() / COMPRESS_MOD
+            size_t lo = n < 2 ? 0 : n - 2;
+            v.assign(x.size() + y.size() - lo, 0);
+            for (size_t i = 0; i < y.size(); i++) {
+                ucarry_t add = 0, yv = y.v[i];
+                size_t j = lo > i ? lo - i : 0;
+                if (j >= x.size()) continue;
+                for (; j < x.size(); ++j)
+                    carry(add, v[i + j - lo], v[i + j - lo] + yv * x.v[j]);
+                v[i + x.size() - lo] = (base_t)add;
+            }
+            raw_shr(n - lo);
+        } else if (n > y.size() + 1) {
+            // the dropped limbs of x are less than COMPRESS_MOD^(n - 1) in the product
+            size_t k = n - y.size() - 1;
+            raw_nttmul(x.raw_view().shr(k), y);
+            raw_shr(n - k);
+        } else {
+            raw_nttmul(x, y);
+            raw_shr(n);
+        }
+        trim();
+        sign = a.sign * b.sign;
+        return *this;
+    }
     BigInt_t &raw_div(const BigInt_t &a, const BigInt_t &b, BigInt_t &r) {
         r = a;
         if (a.raw_less(b)) {
@@ -380,145 +635,327 @@ protected:
         BigInt_t r;
         if (n >= size()) return r;
         r.v.assign(v.begin() + n, v.end());
-        return BIGINT_STD_MOVE(r);
+        return r;
+    }
+    // the top n limbs, padded with zeros if there are not enough limbs
+    BigInt_t raw_top_to(size_t n) const {
+        if (n <= size()) return raw_shr_to(size() - n);
+        BigInt_t r = *this;
+        r.raw_shl(n - size());
+        return r;
     }
     BigInt_t raw_lowdigits_to(size_t n) const {
         if (n >= size()) return *this;
         BigInt_t r;
         r.v.assign(v.begin(), v.begin() + n);
         r.trim();
-        return BIGINT_STD_MOVE(r);
+        return r;
+    }
+    // the magnitude in 32-bit words from the lowest, for the exponents
+    std::vector<uint32_t> raw_words() const {
+        std::vector<uint32_t> w;
+        for (size_t i = v.size() - 1; i < v.size(); --i) {
+            uint64_t add = v[i];
+            for (size_t j = 0; j < w.size(); ++j) {
+                add += (uint64_t)w[j] * COMPRESS_MOD;
+                w[j] = (uint32_t)add;
+                add >>= 32;
+            }
+            if (add) w.push_back((uint32_t)add);
+        }
+        return w;
     }
     BigInt_t &raw_shl(size_t n) {
         if (n == 0 || is_zero()) return *this;
         v.insert(v.begin(), n, 0);
         return *this;
     }
-    BigInt_t &keep(size_t n) {
-        size_t s = n < v.size() ? v.size() - n : (size_t)0;
-        if (s && v[s - 1] >= COMPRESS_MOD >> 1) ++v[s];
-        return raw_shr(s);
-    }
+    // Newton iteration on the reciprocal x = COMPRESS_MOD^(2p) / bp, bp is the top p limbs of b
+    // (padded with zeros when the quotient is longer than b)
+    // each step gets the middle part of bp * x by a wrap-around product and then
+    // corrects x by a short product, which only keeps the high part
     BigInt_t &raw_fastdiv(const BigInt_t &a, const BigInt_t &b) {
         if (a.raw_less(b)) {
             set(0);
             return *this;
         }
-        if (b.size() * 2 - 2 > a.size()) {
-            BigInt_t ta = a, tb = b;
-            size_t ans_len = a.size() - b.size() + 2;
-            size_t r = b.size() - ans_len;
-            ta.raw_shr(r);
-            tb.raw_shr(r);
-            return raw_fastdiv(ta, tb);
-        }
         if (b.size() < BIGINT_DIV_THRESHOLD) {
             BigInt_t r;
             return raw_div(a, b, r);
         }
-        size_t extand_digs = 2;
-        size_t ans_len = a.size() - b.size() + extand_digs + 1, s_len = ans_len + 32;
+        size_t n = b.size(), p = a.size() - n + 4;
         std::vector<size_t> len_seq;
-        BigInt_t b2, x0, x1, t;
-        x1.v.resize(1);
-        x1.v.back() = (base_t)(COMPRESS_MOD / (b.v.back() + (double)(b.v[b.size() - 2]) / COMPRESS_MOD));
-        x0.v.push_back(x1.v.back() + 1);
-        size_t keep_size = 1;
-        while (s_len > 32) {
-            len_seq.push_back(std::min(s_len, ans_len));
-            s_len = s_len / 2 + 1;
-        }
-        while (x1 != x0) {
-            // x1 = x0(2 - x0 * b)
-            x0 = x1;
-            b2 = b;
-            size_t tsize = std::min(keep_size * 2, ans_len);
-            b2.keep(tsize);
-            t = x0 * b2;
-            t.keep(tsize);
-            for (size_t i = t.size() - 2; i < t.size(); --i)
-                t.v[i] = COMPRESS_MOD - 1 - t.v[i];
-            if (t.v.back() != 1) {
-                t.v.back() = COMPRESS_MOD - 1 - t.v.back();
-                t.v.push_back(1);
-            } else {
-                t.v.pop_back();
-                t.trim();
+        for (; p > BIGINT_MUL_THRESHOLD; p = p / 2 + 2)
+            len_seq.push_back(p);
+        BigInt_t x, e, t;
+        t.v.assign(p * 2 + 1, 0);
+        t.v.back() = 1;
+        x.raw_dividediv(t, b.raw_top_to(p), e);
+        for (size_t h = p; !len_seq.empty(); len_seq.pop_back(), h = p) {
+            p = len_seq.back();
+            // e = bp * x - COMPRESS_MOD^(p + h), |e| < COMPRESS_MOD^(p + 2)
+            size_t wrap = 1;
+            while (wrap < p + 3)
+                wrap *= 2;
+            e.raw_nttmul_wrap(b.raw_top_to(p), x, wrap);
+            e.v.resize(wrap);
+            size_t i = (p + h) % wrap;
+            for (; e.v[i] == 0; i = (i + 1) % wrap)
+                e.v[i] = COMPRESS_MOD - 1;
+            --e.v[i];
+            bool neg = e.v.back() >= COMPRESS_MOD / 2;
+            if (neg) {
+                for (size_t i = 0; i < e.size(); ++i)
+                    e.v[i] = COMPRESS_MOD - 1 - e.v[i];
             }
-            x1 *= t;
-            keep_size = std::min(keep_size * 2, s_len);
-            x1.keep(keep_size);
-        }
-        for (; !len_seq.empty(); len_seq.pop_back()) {
-            // x1 = x0(2 - x0 * b)
-            x0 = x1;
-            b2 = b;
-            size_t tsize = std::min(keep_size * 2, ans_len);
-            b2.keep(tsize);
-            t = x0 * b2;
-            t.keep(tsize);
-            for (size_t i = t.size() - 2; i < t.size(); --i)
-                t.v[i] = COMPRESS_MOD - 1 - t.v[i];
-            if (t.v.back() != 1) {
-                t.v.back() = COMPRESS_MOD - 1 - t.v.back();
-                t.v.push_back(1);
+            e.trim();
+            // x = x - x * e / COMPRESS_MOD^(2h)
+            t.raw_mul_high(x, e, h * 2);
+            x.raw_shl(p - h);
+            neg ? x.raw_add(t) : x.raw_sub(t);
+        }
+        // keep one more limb to round the quotient
+        raw_mul_high(a, x, n + p - 1);
+        base_t f = v[0];
+        raw_shr(1);
+        sign = 1;
+        if (f <= 3 || f >= COMPRESS_MOD - 4) {
+            // too close to an integer, fix it with the remainder
+            BigInt_t ta = a, tb = b;
+            ta.sign = tb.sign = 1;
+            BigInt_t r = ta - *this * tb;
+            for (; r.sign < 0 && !r.is_zero(); r += tb)
+                raw_sub(BigInt_t(1));
+            for (; !r.raw_less(tb); r.raw_sub(tb))
+                raw_add(BigInt_t(1));
+        }
+        return *this;
+    }
+    // an upper bound of the bit length
+    size_t raw_bits() const { return (size() - 1) * (COMPRESS_DIGITS * 10 / 3 + 1) + NTT_NS::log2(v.back()) + 1; }
+    // *this = floor(a^(1/k)) for a > 0, Newton iteration from above
+    // the start point comes from the root of the top limbs, so only a few steps are needed
+    BigInt_t &raw_root(const BigInt_t &a, uint32_t k) {
+        size_t t = (a.size() - 1) / ((size_t)k * 2);
+        if (t == 0) {
+            std::vector<uint32_t> w(1, (uint32_t)((a.raw_bits() + k - 1) / k));
+            *this = POW_NS::pow_window(POW_NS::mul_ctx<BigInt_t>(), BigInt_t(2), w);
+        } else {
+            raw_root(a.raw_shr_to(t * k), k);
+            raw_add(BigInt_t(1));
+            raw_shl(t);
+        }
+        std::vector<uint32_t> w(1, k - 1);
+        BigInt_t km1((intmax_t)k - 1), kb((intmax_t)k), y;
+        for (;;) {
+            y = *this * km1;
+            y.raw_add(a / POW_NS::pow_window(POW_NS::mul_ctx<BigInt_t>(), *this, w));
+            y = y / kb;
+            if (!y.raw_less(*this)) break;
+            v.swap(y.v);
+        }
+        return *this;
+    }
+    // Karatsuba square root, a has n * 2 limbs and the top limb is at least COMPRESS_MOD / 4
+    // *this = floor(sqrt(a)), r = a - *this * *this
+    BigInt_t &raw_sqrt_rem_norm(const BigInt_t &a, size_t n, BigInt_t &r) {
+        if (n <= 2) {
+            raw_root(a, 2);
+            r = a - *this * *this;
+            return *this;
+        }
+        // the high root limbs from the top half, then the low l limbs by one division
+        size_t l = n / 2;
+        raw_sqrt_rem_norm(a.raw_shr_to(l * 2), n - l, r);
+        BigInt_t d = *this + *this, q, u;
+        r.raw_shl(l);
+        r += a.raw_shr_to(l).raw_lowdigits_to(l);
+        q = r / d;
+        u = r - q * d;
+        raw_shl(l);
+        *this += q;
+        u.raw_shl(l);
+        u += a.raw_lowdigits_to(l);
+        r = u - q * q;
+        if (r.sign < 0 && !r.is_zero()) {
+            r += *this;
+            raw_sub(BigInt_t(1));
+            r += *this;
+        }
+        return *this;
+    }
+    // *this = floor(sqrt(a)), r = a - *this * *this for a > 0
+    // a is scaled by m^2 to an even number of limbs with a large top limb, then the root S and the
+    // remainder R of b = a * m^2 are scaled back. with S = s * m + s0, r = (R + s0 * (2S - s0)) / m^2
+    BigInt_t &raw_sqrt_rem(const BigInt_t &a, BigInt_t &r) {
+        if (a.size() <= 4) {
+            raw_root(a, 2);
+            r = a - *this * *this;
+            return *this;
+        }
+        // m is found on the top limbs, the product is checked in case a carry from below was missed
+        double top = a.v.back() + (double)a.v[a.size() - 2] / COMPRESS_MOD;
+        size_t n = a.size();
+        uint64_t m = 1;
+        for (; n % 2 || top < COMPRESS_MOD / 4; m *= 2) {
+            top *= 4;
+            if (top >= COMPRESS_MOD) top /= COMPRESS_MOD, ++n;
+        }
+        BigInt_t b = a * (m * m);
+        for (; b.size() % 2 || b.v.back() < COMPRESS_MOD / 4; m *= 2)
+            b *= 4;
+        raw_sqrt_rem_norm(b, b.size() / 2, r);
+        if (m > 1) {
+            BigInt_t s0 = *this % m, t = *this + *this;
+            t -= s0;
+            r += t * s0;
+            r /= m;
+            r /= m;
+            *this /= m;
+        }
+        return *this;
+    }
+    // limb range kernels used by the divide and conquer division
+    static bool raw_less_n(const base_t *a, const base_t *b, size_t n) {
+        for (size_t i = n - 1; i < n; i--)
+            if (a[i] != b[i]) return a[i] < b[i];
+        return false; // eq
+    }
+    static base_t raw_add_n(base_t *r, const base_t *b, size_t n) {
+        ucarry_t add = 0;
+        for (size_t i = 0; i < n; i++)
+            carry1(add, r[i], (ucarry_t)r[i] + b[i]);
+        return (base_t)add;
+    }
+    static base_t raw_sub_n(base_t *r, const base_t *b, size_t n) {
+        carry_t add = 0;
+        for (size_t i = 0; i < n; i++)
+            borrow1(add, r[i], (carry_t)r[i] - (carry_t)b[i]);
+        return (base_t)-add;
+    }
+    static base_t raw_dec_n(base_t *r, size_t n) {
+        for (size_t i = 0; i < n; i++) {
+            if (r[i]) {
+                --r[i];
+                return 0;
+            }
+            r[i] = COMPRESS_MOD - 1;
+        }
+        return 1;
+    }
+    // r[0, an + bn) = a * b, ws[0..2] are scratch numbers which keep their capacity
+    static void raw_mul_n(base_t *r, const base_t *a, size_t an, const base_t *b, size_t bn, BigInt_t *ws) {
+        if (std::min(an, bn) <= BIGINT_MUL_THRESHOLD) {
+            std::fill(r, r + an + bn, 0);
+            for (size_t i = 0; i < an; i++) {
+                ucarry_t add = 0, av = a[i];
+                for (size_t j = 0; j < bn; ++j)
+                    carry(add, r[i + j], r[i + j] + av * b[j]);
+                r[i + bn] = (base_t)add;
+            }
+            return;
+        }
+        ws[0].v.assign(a, a + an);
+        ws[0].trim();
+        ws[1].v.assign(b, b + bn);
+        ws[1].trim();
+        ws[2].raw_nttmul(ws[0], ws[1]);
+        std::copy(ws[2].v.begin(), ws[2].v.end(), r);
+        std::fill(r + ws[2].size(), r + an + bn, 0);
+    }
+    // schoolbook division of a[0, an) by the normalized b[0, bn), the quotient is
+    // written to q[0, an - bn) and the returned high limb, the remainder is left in a[0, bn)
+    static base_t raw_div_basecase(base_t *q, base_t *a, size_t an, const base_t *b, size_t bn) {
+        base_t qh = !raw_less_n(a + an - bn, b, bn);
+        if (qh) raw_sub_n(a + an - bn, b, bn);
+        ucarry_t b1 = b[bn - 1], b0 = b[bn - 2];
+        for (size_t i = an - bn - 1; i < an; i--) {
+            base_t *p = a + i;
+            ucarry_t rm = (ucarry_t)p[bn] * COMPRESS_MOD + p[bn - 1], m, rem;
+            if (p[bn] >= b1) {
+                m = COMPRESS_MOD - 1;
+                rem = rm - m * b1;
             } else {
-                t.v.pop_back();
-                t.trim();
+                m = rm / b1;
+                rem = rm - m * b1;
             }
-            ucarry_t add = 1;
-            for (size_t i = 0; add && i < t.v.size(); i++)
-                carry(add, t.v[i], (ucarry_t)t.v[i]);
-            if (add) t.v.push_back((base_t)add);
-            x1 *= t;
-            keep_size = len_seq.back();
-            x1.keep(keep_size);
-        }
-        x1 *= a;
-        if (x1.v[a.size() + extand_digs - 1] >= COMPRESS_MOD - 1)
-            *this = x1.raw_shr(a.size() + extand_digs).raw_add(BigInt_t(1));
-        else
-            *this = x1.raw_shr(a.size() + extand_digs);
-        return *this;
+            while (rem < COMPRESS_MOD && m * b0 > rem * COMPRESS_MOD + p[bn - 2]) {
+                --m;
+                rem += b1;
+            }
+            ucarry_t mul = 0;
+            carry_t add = 0;
+            for (size_t j = 0; j < bn; j++) {
+                mul += m * b[j];
+                borrow(add, p[j], (carry_t)p[j] - (carry_t)low_digit(mul));
+                mul = high_digit(mul);
+            }
+            borrow(add, p[bn], (carry_t)p[bn] - (carry_t)mul);
+            if (add) {
+                --m;
+                raw_add_n(p, b, bn);
+            }
+            p[bn] = 0;
+            q[i] = (base_t)m;
+        }
+        return qh;
     }
+    // Burnikel-Ziegler 2n/1n division, a[0, 2n) / b[0, n), the quotient is written to
+    // q[0, n) and the returned high limb, the remainder is left in a[0, n)
+    // tp is a workspace of n limbs shared by all the recursion levels
+    static base_t raw_div_2n1n(base_t *q, base_t *a, const base_t *b, size_t n, base_t *tp, BigInt_t *ws) {
+        if (n <= BIGINT_DIVIDEDIV_THRESHOLD) return raw_div_basecase(q, a, n * 2, b, n);
+        size_t lo = n / 2, hi = n - lo;
+        // 3n/2n step on the high half
+        base_t qh = raw_div_2n1n(q + lo, a + lo * 2, b + lo, hi, tp, ws);
+        raw_mul_n(tp, q + lo, hi, b, lo, ws);
+        base_t cy = raw_sub_n(a + lo, tp, n);
+        if (qh) cy += raw_sub_n(a + n, b, lo);
+        while (cy) {
+            qh -= raw_dec_n(q + lo, hi);
+            cy -= raw_add_n(a + lo, b, n);
+        }
+        // 3n/2n step on the low half
+        base_t ql = raw_div_2n1n(q, a + hi, b + hi, lo, tp, ws);
+        raw_mul_n(tp, b, hi, q, lo, ws);
+        cy = raw_sub_n(a, tp, n);
+        if (ql) cy += raw_sub_n(a + lo, b, hi);
+        while (cy) {
+            raw_dec_n(q, lo);
+            cy -= raw_add_n(a, b, n);
+        }
+        return qh;
+    }
+    // b must be normalized, the quotient is computed block by block with 2n/1n divisions
     BigInt_t &raw_dividediv_recursion(const BigInt_t &a, const BigInt_t &b, BigInt_t &r) {
-        if (a < b) {
+        if (a.raw_less(b)) {
             r = a;
             return set(0);
         } else if (b.size() <= BIGINT_DIVIDEDIV_THRESHOLD) {
             return raw_div(a, b, r);
         }
-        size_t base = (b.size() + 1) / 2;
-        if (a.size() <= base * 3) {
-            base = b.size() / 2;
-            BigInt_t ma = a, mb = b, e;
-            BigInt_t ha = ma.raw_shr_to(base);
-            BigInt_t hb = mb.raw_shr_to(base);
-            raw_dividediv_recursion(ha, hb, r);
-            ha = *this * b;
-            while (a < ha) {
-                ha.raw_sub(b);
-                raw_sub(BigInt_t(1));
-            }
-            r = a - ha;
-            return *this;
+        size_t n = b.size(), blocks = (a.size() - 1) / n;
+        std::vector<base_t> tp(n);
+        BigInt_t ws[3];
+        r.v.resize((blocks + 1) * n);
+        std::copy(a.v.begin(), a.v.end(), r.v.begin());
+        std::fill(r.v.begin() + a.size(), r.v.end(), 0);
+        v.assign(blocks * n + 1, 0);
+        sign = r.sign = 1;
+        base_t *rp = &r.v.front(), *qp = &v.front();
+        if (!raw_less_n(rp + blocks * n, &b.v.front(), n)) {
+            raw_sub_n(rp + blocks * n, &b.v.front(), n);
+            qp[blocks * n] = 1;
         }
-        if (a.size() > base * 4) base = a.size() / 2;
-        BigInt_t ha = a.raw_shr_to(base);
-        BigInt_t c, d, m;
-        raw_dividediv_recursion(ha, b, d);
-        raw_shl(base);
-        m.v.resize(base + d.size());
-        for (size_t i = 0; i < base; ++i)
-            m.v[i] = a.v[i];
-        for (size_t i = 0; i < d.size(); ++i)
-            m.v[base + i] = d.v[i];
-        c.raw_dividediv_recursion(m, b, r);
-        raw_add(c);
+        for (size_t i = blocks - 1; i < blocks; i--)
+            raw_div_2n1n(qp + i * n, rp + i * n, &b.v.front(), n, &tp.front(), ws);
+        r.v.resize(n);
+        r.trim();
+        trim();
         return *this;
     }
     BigInt_t &raw_dividediv(const BigInt_t &a, const BigInt_t &b, BigInt_t &r) {
-        if (b.size() <= BIGINT_DIVIDEDIV_THRESHOLD) {
+        if (b.size() <= BIGINT_DIVIDEDIV_THRESHOLD || a.raw_less(b)) {
             raw_div(a, b, r);
             return *this;
         }
@@ -528,11 +965,25 @@ protected:
             size_t shr = b.size() - ans_len;
             ta.raw_shr(shr);
             tb.raw_shr(shr);
-            return raw_dividediv(ta, tb, r);
+            raw_dividediv(ta, tb, r);
+            // the quotient of the top limbs can be off by a few, fix it with the whole numbers
+            BigInt_t t;
+            t.raw_nttmul(*this, b);
+            r = a;
+            sign = r.sign = t.sign = 1;
+            for (; r.raw_less(t); raw_sub(BigInt_t(1)))
+                t.raw_sub(b);
+            r.raw_sub(t);
+            for (; !r.raw_less(b); raw_add(BigInt_t(1)))
+                r.raw_sub(b);
+            return *this;
         }
-        carry_t mul = (carry_t)(((uint64_t)(COMPRESS_MOD + 1) * (COMPRESS_MOD - 1)) /       //
-                                (*(b.v.begin() + b.v.size() - 1) * (uint64_t)COMPRESS_MOD + //
-                                 *(b.v.begin() + b.v.size() - 2) + 1));
+        // the top limb of a normalized divisor is already large enough
+        carry_t mul = 1;
+        if (b.v.back() < COMPRESS_MOD >> 1)
+            mul = (carry_t)(((uint64_t)(COMPRESS_MOD + 1) * (COMPRESS_MOD - 1)) /       //
+                            (*(b.v.begin() + b.v.size() - 1) * (uint64_t)COMPRESS_MOD + //
+                             *(b.v.begin() + b.v.size() - 2) + 1));
         BigInt_t ma = a * BigInt_t((intmax_t)mul), mb = b * BigInt_t((intmax_t)mul);
         while (mb.v.back() < COMPRESS_MOD >> 1) {
             int32_t m = 2;
@@ -551,9 +1002,129 @@ protected:
             v.pop_back();
     }
     size_t size() const { return v.size(); }
+    // kernels for a machine integer operand, given as sign and magnitude
+    static size_t raw_split(base_t d[], uint64_t m) {
+        size_t k = 0;
+        do {
+            d[k++] = (base_t)(m % COMPRESS_MOD);
+            m /= COMPRESS_MOD;
+        } while (m);
+        return k;
+    }
+    int raw_cmp_small(uint64_t m) const {
+        base_t d[8];
+        size_t k = raw_split(d, m);
+        if (size() != k) return size() < k ? -1 : 1;
+        for (size_t i = k; i-- > 0;)
+            if (v[i] != d[i]) return v[i] < d[i] ? -1 : 1;
+        return 0;
+    }
+    int raw_cmp_small(bool neg, uint64_t m) const {
+        bool n = sign < 0 && !is_zero();
+        neg = neg && m;
+        if (n != neg) return n ? -1 : 1;
+        int c = raw_cmp_small(m);
+        return n ? -c : c;
+    }
+    BigInt_t &raw_set_small(bool neg, uint64_t m) {
+        base_t d[8] = {0};
+        size_t k = raw_split(d, m);
+        v.assign(d, d + k);
+        sign = neg && m ? -1 : 1;
+        return *this;
+    }
+    BigInt_t &raw_add_small(bool neg, uint64_t m) {
+        if (m == 0) return *this;
+        if (is_zero()) return raw_set_small(neg, m);
+        v.unshare();
+        if ((sign < 0) == neg) {
+            for (size_t i = 0; m; ++i) {
+                if (i == size()) v.push_back(0);
+                uint64_t t = m % COMPRESS_MOD + v[i];
+                v[i] = (base_t)(t % COMPRESS_MOD);
+                m = m / COMPRESS_MOD + t / COMPRESS_MOD;
+            }
+            return *this;
+        }
+        if (raw_cmp_small(m) < 0) {
+            // |*this| < m fits in the machine integer
+            uint64_t s = 0;
+            for (size_t i = size(); i-- > 0;)
+                s = s * COMPRESS_MOD + v[i];
+            return raw_set_small(neg, m - s);
+        }
+        for (size_t i = 0; m; ++i) {
+            uint64_t t = m % COMPRESS_MOD;
+            m /= COMPRESS_MOD;
+            if (v[i] >= t) {
+                v[i] -= (base_t)t;
+            } else {
+                v[i] = (base_t)(v[i] + COMPRESS_MOD - t);
+                ++m;
+            }
+        }
+        trim();
+        if (is_zero()) sign = 1;
+        return *this;
+    }
+    BigInt_t &raw_mul_small(bool neg, uint64_t m) {
+        if (m < (uint64_t)COMPRESS_MOD) {
+            raw_mul_int((base_t)m);
+        } else {
+            // multiply in place from the top limb down
+            base_t d[8];
+            size_t k = raw_split(d, m), n = size();
+            v.resize(n + k, 0);
+            for (size_t i = n; i-- > 0;) {
+                uint64_t x = v[i], c = 0;
+                v[i] = 0;
+                for (size_t j = 0; j < k; ++j) {
+                    c += x * d[j] + v[i + j];
+                    v[i + j] = (base_t)(c % COMPRESS_MOD);
+                    c /= COMPRESS_MOD;
+                }
+                for (size_t j = i + k; c; ++j) {
+                    c += v[j];
+                    v[j] = (base_t)(c % COMPRESS_MOD);
+                    c /= COMPRESS_MOD;
+                }
+            }
+            trim();
+        }
+        if (neg) sign = -sign;
+        if (is_zero()) sign = 1;
+        return *this;
+    }
+    BigInt_t &raw_div_small(bool neg, uint64_t m) {
+        if (m > ~(uint64_t)0 / COMPRESS_MOD) {
+            BigInt_t b;
+            return *this /= b.raw_set_small(neg, m);
+        }
+        v.unshare();
+        uint64_t r = 0;
+        for (size_t i = size(); i-- > 0;) {
+            r = r * COMPRESS_MOD + v[i];
+            v[i] = (base_t)(r / m);
+            r %= m;
+        }
+        trim();
+        if (neg) sign = -sign;
+        if (is_zero()) sign = 1;
+        return *this;
+    }
+    BigInt_t &raw_mod_small(uint64_t m) {
+        if (m > ~(uint64_t)0 / COMPRESS_MOD) {
+            BigInt_t b;
+            return *this %= b.raw_set_small(false, m);
+        }
+        uint64_t r = 0;
+        for (size_t i = size(); i-- > 0;)
+            r = (r * COMPRESS_MOD + v[i]) % m;
+        return raw_set_small(sign < 0, r);
+    }
     //{decm_e}
-    BigIntBase transbase(int32_t out_base) const {
-        if (size() <= 8) {
+    static BigIntBase raw_transbase(const view_t &a, int32_t out_base) {
+        if (a.size() <= 8) {
             BigIntBase sum(out_base);
             BigIntBase base(out_base);
             BigIntBase ownbase(out_base);
@@ -562,17 +1133,17 @@ protected:
                 base.set(1);
                 BigIntBase mul(out_base);
                 mul = base;
-                mul.raw_mul_int(v[0]);
+                mul.raw_mul_int(a.v[0]);
                 sum.raw_add(mul);
             }
-            for (size_t i = 1; i < v.size(); i++) {
+            for (size_t i = 1; i < a.size(); i++) {
                 base.raw_mul(ownbase, BigIntBase(base));
                 BigIntBase mul(out_base);
                 mul = base;
-                mul.raw_mul_int(v[i]);
+                mul.raw_mul_int(a.v[i]);
                 sum.raw_add(mul);
             }
-            return BIGINT_STD_MOVE(sum);
+            return sum;
         } else {
             static std::vector<BigIntBase> pow_list;
             static int32_t last_base = 0, pow_list_cnt;
@@ -584,7 +1155,7 @@ protected:
                 last_base = out_base;
             }
             size_t s = 1, id = 0;
-            for (; s < size() / 3; s *= 2, ++id) {
+            for (; s < a.size() / 3; s *= 2, ++id) {
                 if (s >= (size_t)1 << pow_list_cnt) {
                     pow_list.push_back(BigIntBase(out_base));
                     pow_list.back().raw_nttsqr(pow_list[pow_list_cnt]);
@@ -592,18 +1163,16 @@ protected:
                 }
             }
             base = pow_list[id];
-            BigInt_t h = raw_shr_to(s), l = *this;
-            l.v.resize(s);
-            BigIntBase r = h.transbase(out_base);
+            BigIntBase r = raw_transbase(a.shr(s), out_base);
             BigIntBase sum(out_base);
             sum.raw_nttmul(r, base);
-            r = l.transbase(out_base);
+            r = raw_transbase(a.low(s), out_base);
             sum.raw_add(r);
-            return BIGINT_STD_MOVE(sum);
+            return sum;
         }
     }
     std::string out_mul(int32_t out_base = 10, int32_t pack = 0) const {
-        BigIntBase sum = transbase(out_base);
+        BigIntBase sum = raw_transbase(*this, out_base);
         std::string out;
         int32_t d = 0;
         for (size_t i = 0, j = 0;;) {
@@ -687,10 +1256,10 @@ protected:
         return *this;
     }
     //{decm_e}
-    BigInt_t &_from_str(const std::string &s, int base) {
-        if (s.size() <= 12) {
+    BigInt_t &_from_str(const char *s, size_t n, int base) {
+        if (n <= 12) {
             int64_t v = 0;
-            for (size_t i = 0; i < s.size(); ++i) {
+            for (size_t i = 0; i < n; ++i) {
                 int digit = -1;
                 if (s[i] >= '0' && s[i] <= '9')
                     digit = s[i] - '0';
@@ -704,17 +1273,19 @@ protected:
         }
         BigInt_t m(base), h;
         size_t len = 1;
-        for (; len * 3 < s.size(); len *= 2) {
+        for (; len * 3 < n; len *= 2) {
             m *= m;
         }
-        h._from_str(s.substr(0, s.size() - len), base);
-        _from_str(s.substr(s.size() - len), base);
+        h._from_str(s, n - len, base);
+        _from_str(s + n - len, len, base);
         *this += m * h;
         return *this;
     }
     //{decm_b}
 public:
     BigIntDec() { set(0); }
+    // zero, the limbs of this number are taken from the arena, which must outlive it
+    explicit BigIntDec(BigIntArena &arena) : v(arena) { set(0); }
     explicit BigIntDec(int n) { set(n); }
     explicit BigIntDec(intmax_t n) { set(n); }
     explicit BigIntDec(const char *s, int base = 10) { from_str(s, base); }
@@ -749,7 +1320,7 @@ public:
             ++i;
             vsign = -vsign;
         }
-        _from_str(std::string(s + i), base);
+        _from_str(s + i, strlen(s + i), base);
         sign = vsign;
         return *this;
         //{decm_b}
@@ -778,15 +1349,16 @@ public:
         return raw_eq(b);
     }
     LESS_THAN_AND_EQUAL_COMPARABLE(BigInt_t)
+    BIGINT_ALL_INT_OPERATORS(BigInt_t)
 
     BigInt_t &operator=(intmax_t n) { return set(n); }
     BigInt_t &operator=(const char *s) { return from_str(s); }
     BigInt_t &operator=(const std::string s) { return from_str(s); }
-    BigInt_t operator+(const BigInt_t &b) const {
+    BigInt_t operator+(const BigInt_t &b) BIGINT_CONST_REF {
         if (sign * b.sign > 0)
             return BIGINT_STD_MOVE(BigInt_t(*this).raw_add(b));
         else if (size() < b.size())
-            return BIGINT_STD_MOVE(BigInt_t(b).raw_sub(*this).inv());
+            return BIGINT_STD_MOVE(BigInt_t(b).raw_sub(*this));
         else
             return BIGINT_STD_MOVE(BigInt_t(*this).raw_sub(b));
     }
@@ -796,13 +1368,13 @@ public:
         if (sign * b.sign > 0)
             raw_add(b);
         else if (size() < b.size())
-            *this = BIGINT_STD_MOVE(BigInt_t(b).raw_sub(*this).inv());
+            *this = BIGINT_STD_MOVE(BigInt_t(b).raw_sub(*this));
         else
             raw_sub(b);
         return *this;
     }
 
-    BigInt_t operator-(const BigInt_t &b) const {
+    BigInt_t operator-(const BigInt_t &b) BIGINT_CONST_REF {
         if (sign * b.sign < 0)
             return BIGINT_STD_MOVE(BigInt_t(*this).raw_add(b));
         else if (size() < b.size())
@@ -831,17 +1403,17 @@ public:
         return BIGINT_STD_MOVE(BigInt_t(*this).inv());
     }
 
-    BigInt_t operator*(const BigInt_t &b) const {
+    BigInt_t operator*(const BigInt_t &b) BIGINT_CONST_REF {
         if (b.size() == 1) {
             BigInt_t r = *this;
             r.raw_mul_int((uint32_t)b.v[0]);
             r.sign *= b.sign;
-            return BIGINT_STD_MOVE(r);
+            return r;
         } else if (v.size() == 1) {
             BigInt_t r = b;
             r.raw_mul_int((uint32_t)v[0]);
             r.sign *= sign;
-            return BIGINT_STD_MOVE(r);
+            return r;
         } else {
             BigInt_t r;
             if (raw_less(b))
@@ -849,7 +1421,7 @@ public:
             else
                 r.raw_nttmul(b, *this);
             r.sign = sign * b.sign;
-            return BIGINT_STD_MOVE(r);
+            return r;
         }
     }
     BigInt_t &operator*=(const BigInt_t &b) {
@@ -858,25 +1430,46 @@ public:
             sign *= b.sign;
             return *this;
         } else {
-            return *this = *this * b;
+            BigInt_t r = *this * b;
+            v.swap(r.v);
+            sign = r.sign;
+            return *this;
         }
     }
 
-    BigInt_t operator/(const BigInt_t &b) const {
+    BigInt_t operator/(const BigInt_t &b) BIGINT_CONST_REF {
         BigInt_t r, d;
         if (b.size() > BIGINT_DIV_THRESHOLD)
             d.raw_fastdiv(*this, b);
         else
             d.raw_dividediv(*this, b, r);
         d.sign = sign * b.sign;
-        return BIGINT_STD_MOVE(d);
+        return d;
     }
     BigInt_t &operator/=(const BigInt_t &b) {
         if (this == &b) {
             return set(1);
         }
-        return *this = *this / b;
+        BigInt_t d = *this / b;
+        v.swap(d.v);
+        sign = d.sign;
+        return *this;
     }
+#if BIGINT_RVALUE_REF
+    // a temporary left operand keeps its buffer for the result
+    BigInt_t operator+(const BigInt_t &b) && { return BIGINT_STD_MOVE(*this += b); }
+    BigInt_t operator+(BigInt_t &&b) const & { return BIGINT_STD_MOVE(b += *this); }
+    BigInt_t operator+(BigInt_t &&b) && { return BIGINT_STD_MOVE(size() < b.size() ? b += *this : *this += b); }
+    BigInt_t operator-(const BigInt_t &b) && { return BIGINT_STD_MOVE(*this -= b); }
+    BigInt_t operator-(BigInt_t &&b) const & {
+        b -= *this;
+        if (!b.is_zero()) b.inv();
+        return BIGINT_STD_MOVE(b);
+    }
+    BigInt_t operator-(BigInt_t &&b) && { return BIGINT_STD_MOVE(*this -= b); }
+    BigInt_t operator*(const BigInt_t &b) && { return BIGINT_STD_MOVE(*this *= b); }
+    BigInt_t operator/(const BigInt_t &b) && { return BIGINT_STD_MOVE(*this /= b); }
+#endif
     BigInt_t operator%(const BigInt_t &b) const {
         if (b.size() == 1 && COMPRESS_MOD % b.v[0] == 0) {
             return BigInt_t((intmax_t)(v[0] % b.v[0]) * sign);
@@ -888,13 +1481,19 @@ public:
     }
     BigInt_t &operator%=(const BigInt_t &b) {
         if (b.size() == 1 && COMPRESS_MOD % b.v[0] == 0) {
-            return set(v[0] % b.v[0] * sign);
+            return set((intmax_t)(v[0] % b.v[0]) * sign);
         }
         if (this == &b) {
             return set(0);
         }
         return *this = *this % b;
     }
+    // *this += a * b, the product of short operands is added in place without a temporary
+    BigInt_t &addmul(const BigInt_t &a, const BigInt_t &b) { return raw_addmul(a, b, 1); }
+    BigInt_t &submul(const BigInt_t &a, const BigInt_t &b) { return raw_addmul(a, b, -1); }
+    template <class E> BigInt_t &operator=(const EXPR_NS::Expr<E> &e) { return EXPR_NS::assign(*this, e.self(), 0); }
+    template <class E> BigInt_t &operator+=(const EXPR_NS::Expr<E> &e) { return EXPR_NS::assign(*this, e.self(), 1); }
+    template <class E> BigInt_t &operator-=(const EXPR_NS::Expr<E> &e) { return EXPR_NS::assign(*this, e.self(), -1); }
     BigInt_t div(const BigInt_t &b, BigInt_t &r) {
         if (this == &b) {
             r.set(0);
@@ -906,8 +1505,28 @@ public:
         r = *this - d * b;
         // d.raw_dividediv(*this, b, r);
         // d.sign = sign * b.sign;
-        return BIGINT_STD_MOVE(d);
+        return d;
+    }
+
+    // 2^n, there is no cheap shift in base 10
+    static BigInt_t raw_pow2(uint64_t n) {
+        std::vector<uint32_t> w(1, (uint32_t)n);
+        return POW_NS::pow_window(POW_NS::mul_ctx<BigInt_t>(), BigInt_t(2), w);
+    }
+    // n!, the odd part by prime swing and then the power of 2
+    static BigInt_t factorial(uint32_t n) {
+        BigInt_t r = COMB_NS::odd_factorial<BigInt_t>(n, COMB_NS::primes(n));
+        return r * raw_pow2(COMB_NS::factorial_twos(n));
+    }
+    // n! / (k! (n - k)!), 0 if k > n
+    static BigInt_t binomial(uint32_t n, uint32_t k) {
+        if (k > n) return BigInt_t(0);
+        uint64_t twos;
+        BigInt_t r = COMB_NS::odd_binomial<BigInt_t>(n, k, twos);
+        return r * raw_pow2(twos);
     }
+    // the product of the primes not greater than n
+    static BigInt_t primorial(uint32_t n) { return COMB_NS::primorial<BigInt_t>(n); }
 
     std::string to_str(int32_t out_base = 10, int32_t pack = 0) const {
         //{decm_e}
@@ -920,6 +1539,216 @@ public:
         //{decm_b}
     }
 };
+
+// Barrett reduction for the products modulo a fixed m
+class BigIntDecBarrett {
+protected:
+    typedef BigIntDec BigInt_t;
+    BigInt_t m, mu; // mu = COMPRESS_MOD^(2n) / m, n is the size of m
+    size_t n;
+
+public:
+    explicit BigIntDecBarrett(const BigInt_t &mod) : m(mod), n(mod.size()) {
+        m.sign = 1;
+        mu.v.assign(n * 2 + 1, 0);
+        mu.v.back() = 1;
+        mu /= m;
+    }
+    const BigInt_t &mod() const { return m; }
+    BigInt_t one() const { return reduce(BigInt_t(1)); }
+    // a mod m, in [0, m)
+    BigInt_t reduce(const BigInt_t &a) const {
+        BigInt_t r = a;
+        if (r.sign < 0 || r.size() > n * 2) {
+            r %= m;
+            if (r.sign < 0 && !r.is_zero()) r += m;
+            r.sign = 1;
+            return r;
+        }
+        if (r.size() >= n) {
+            // q is less than a / m by at most 3
+            BigInt_t q, t;
+            q.raw_mul_high(r.raw_shr_to(n - 1), mu, n + 1);
+            t.raw_nttmul(q, m);
+            r.raw_sub(t);
+        }
+        while (!r.raw_less(m))
+            r.raw_sub(m);
+        return r;
+    }
+    BigInt_t mul(const BigInt_t &a, const BigInt_t &b) const {
+        BigInt_t t;
+        t.raw_nttmul(a, b);
+        return reduce(t);
+    }
+    BigInt_t sqr(const BigInt_t &a) const {
+        BigInt_t t;
+        t.raw_nttmul(a, a);
+        return reduce(t);
+    }
+    // a^e mod m, a should be reduced
+    BigInt_t pow(const BigInt_t &a, const BigInt_t &e) const { return POW_NS::pow_window(*this, a, e.raw_words()); }
+};
+
+// precomputed powers of a fixed base g modulo a fixed m
+class BigIntDecPowTable {
+protected:
+    typedef BigIntDec BigInt_t;
+    BigIntDecBarrett barrett;
+    std::vector<BigInt_t> table;
+    size_t k;
+
+public:
+    // the exponents less than 2^bits use the table
+    BigIntDecPowTable(const BigInt_t &g, const BigInt_t &m, size_t bits) : barrett(m), k(POW_NS::fixed_window(bits)) {
+        POW_NS::pow_table(barrett, barrett.reduce(g), bits, k, table);
+    }
+    // g^e mod m
+    BigInt_t pow(const BigInt_t &e) const { return POW_NS::pow_fixed(barrett, table, k, e.raw_words()); }
+};
+
+// sums of many integers, the limbs are added into 64 bit lanes without carrying
+// and the lanes are only normalised before one could overflow, or on readout
+class BigIntDecAccum {
+protected:
+    typedef BigIntDec BigInt_t;
+    typedef uint32_t base_t;
+    std::vector<int64_t> lanes;
+    uint64_t bound; // no lane is larger than this in absolute value
+
+    // a lane is kept below 2^62, the carries of a normalisation can not overflow
+    static uint64_t limit() { return (uint64_t)1 << 62; }
+    void reserve(size_t n, uint64_t add) {
+        if (bound > limit() - add) normalize();
+        bound += add;
+        if (lanes.size() <= n) lanes.resize(n + 1);
+    }
+
+public:
+    BigIntDecAccum() : bound(0) {}
+    void clear() {
+        lanes.clear();
+        bound = 0;
+    }
+    // the lanes below the top one are in [0, COMPRESS_MOD) afterwards
+    BigIntDecAccum &normalize() {
+        int64_t c = 0;
+        for (size_t i = 0; i + 1 < lanes.size(); ++i) {
+            int64_t t = lanes[i] + c, r = t % (int64_t)COMPRESS_MOD;
+            c = t / (int64_t)COMPRESS_MOD;
+            if (r < 0) r += (int64_t)COMPRESS_MOD, --c;
+            lanes[i] = r;
+        }
+        if (lanes.empty()) return *this;
+        lanes.back() += c;
+        while (lanes.back() >= (int64_t)COMPRESS_MOD || lanes.back() <= -(int64_t)COMPRESS_MOD) {
+            int64_t t = lanes.back(), r = t % (int64_t)COMPRESS_MOD;
+            c = t / (int64_t)COMPRESS_MOD;
+            if (r < 0) r += (int64_t)COMPRESS_MOD, --c;
+            lanes.back() = r;
+            lanes.push_back(c);
+        }
+        bound = COMPRESS_MOD;
+        return *this;
+    }
+    // += m * a
+    BigIntDecAccum &addmul(const BigInt_t &a, int32_t m) {
+        if (m == 0 || a.is_zero()) return *this;
+        uint64_t am = m < 0 ? 0 - (uint64_t)m : (uint64_t)m;
+        if (am >= (uint64_t)1 << 29) { // (COMPRESS_MOD - 1) * m stays far below the limit
+            addmul(a, m / 2);
+            return addmul(a, m - m / 2);
+        }
+        reserve(a.size(), (COMPRESS_MOD - 1) * am);
+        int64_t sm = a.sign < 0 ? -(int64_t)m : (int64_t)m;
+        int64_t *p = &lanes[0];
+        const base_t *q = &a.v[0];
+        if (sm == 1)
+            for (size_t i = 0; i < a.size(); ++i)
+                p[i] += q[i];
+        else if (sm == -1)
+            for (size_t i = 0; i < a.size(); ++i)
+                p[i] -= q[i];
+        else
+            for (size_t i = 0; i < a.size(); ++i)
+                p[i] += q[i] * sm;
+        return *this;
+    }
+    BigIntDecAccum &operator+=(const BigInt_t &a) { return addmul(a, 1); }
+    BigIntDecAccum &operator-=(const BigInt_t &a) { return addmul(a, -1); }
+    BigInt_t value() const {
+        BigIntDecAccum t(*this);
+        t.normalize();
+        BigInt_t r;
+        if (t.lanes.empty()) return r;
+        r.v.resize(t.lanes.size());
+        for (size_t i = 0; i + 1 < t.lanes.size(); ++i)
+            r.v[i] = (base_t)t.lanes[i];
+        int64_t top = t.lanes.back();
+        r.v.back() = (base_t)(top < 0 ? 0 : top);
+        r.trim();
+        if (top < 0) {
+            BigInt_t h((intmax_t)-top);
+            h.raw_shl(t.lanes.size() - 1);
+            r -= h;
+        }
+        return r;
+    }
+};
+
+// a^e
+inline BigIntDec pow(const BigIntDec &a, uint64_t e) {
+    std::vector<uint32_t> w(2);
+    w[0] = (uint32_t)e;
+    w[1] = (uint32_t)(e >> 32);
+    return POW_NS::pow_window(POW_NS::mul_ctx<BigIntDec>(), a, w);
+}
+
+// a^e mod m, e should not be negative
+inline BigIntDec powmod(const BigIntDec &a, const BigIntDec &e, const BigIntDec &m) {
+    BigIntDecBarrett barrett(m);
+    return barrett.pow(barrett.reduce(a), e);
+}
+// floor(sqrt(a)), r = a - floor(sqrt(a))^2, a should not be negative
+inline BigIntDec isqrt_rem(const BigIntDec &a, BigIntDec &r) {
+    BigIntDec s;
+    if (a.sign < 0 || a.is_zero()) {
+        r = a;
+        return s;
+    }
+    s.raw_sqrt_rem(a, r);
+    return s;
+}
+
+// floor(sqrt(a)), a should not be negative
+inline BigIntDec isqrt(const BigIntDec &a) {
+    BigIntDec r;
+    return isqrt_rem(a, r);
+}
+
+// a^(1/k) rounded toward zero, k > 0, a should not be negative when k is even
+inline BigIntDec iroot(const BigIntDec &a, uint32_t k) {
+    BigIntDec s;
+    if (k == 1) return a;
+    if (a.is_zero() || (a.sign < 0 && k % 2 == 0)) return s;
+    BigIntDec t = a;
+    t.sign = 1;
+    s.raw_root(t, k);
+    s.sign = a.sign;
+    return s;
+}
+
+// a[0] * b[0] + a[1] * b[1] + ..., the pairs beyond the shorter vector are ignored
+inline BigIntDec dot(const std::vector<BigIntDec> &a, const std::vector<BigIntDec> &b) {
+    BigIntDec r;
+    return r.raw_dot(a, b);
+}
+
+// starts an expression template, r = lazy(a) * b + c is evaluated into r
+inline EXPR_NS::Ref<BigIntDec> lazy(const BigIntDec &a) { return EXPR_NS::Ref<BigIntDec>(a); }
 } // namespace BigIntDecNS
 
 using BigIntDecNS::BigIntDec;
+using BigIntDecNS::BigIntDecBarrett;
+using BigIntDecNS::BigIntDecPowTable;
+using BigIntDecNS::BigIntDecAccum;
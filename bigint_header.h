@@ -39,12 +39,35 @@ typedef int64_t intmax_t;
 #define BIGINT_STD_MOVE
 #endif
 
+//{hex_b}{hexm_b}{dec_b}{decm_b}{mini_b}
+#if __cplusplus >= 201103L || _MSC_VER >= 1900
+#include <exception>
+#include <thread>
+#define BIGINT_THREADS 1
+#define BIGINT_THREAD_LOCAL thread_local
+#define BIGINT_RVALUE_REF 1
+#define BIGINT_CONST_REF const &
+#else
+#define BIGINT_THREADS 0
+#define BIGINT_THREAD_LOCAL
+#define BIGINT_RVALUE_REF 0
+#define BIGINT_CONST_REF const
+#endif
+//{hex_e}{hexm_e}{dec_e}{decm_e}{mini_e}
+
 //{hex_b}{hexm_b}{dec_b}{decm_b}{mini_b}
 #if defined(_WIN64) || defined(_M_X64)
 #define BIGINT_X64 1
 #else
 #define BIGINT_X64 0
 #endif
+#if defined(_MSC_VER)
+#define BIGINT_FORCEINLINE __forceinline
+#elif defined(__GNUC__)
+#define BIGINT_FORCEINLINE inline __attribute__((always_inline))
+#else
+#define BIGINT_FORCEINLINE inline
+#endif
 //{hex_e}{hexm_e}{mini_e}
 #if !defined(BIGINT_LARGE_BASE) && BIGINT_X64
 #define BIGINT_LARGE_BASE 1 // only work with BigIntBase & BigIntDec
@@ -55,3 +78,361 @@ typedef int64_t intmax_t;
     bool operator<=(const T &b) const { return !(b < *this); } \
     bool operator>=(const T &b) const { return !(*this < b); } \
     bool operator!=(const T &b) const { return !(*this == b); }
+
+// int64_t is long or long long depending on the platform, so every spelling gets the operators.
+// C++03 has long long only as an extension
+#if defined(__GNUC__) && __cplusplus < 201103L
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wlong-long"
+#endif
+typedef long long bigint_llong_t;
+typedef unsigned long long bigint_ullong_t;
+#if defined(__GNUC__) && __cplusplus < 201103L
+#pragma GCC diagnostic pop
+#endif
+
+inline bool bigint_int_neg(int n) { return n < 0; }
+inline bool bigint_int_neg(long n) { return n < 0; }
+inline bool bigint_int_neg(bigint_llong_t n) { return n < 0; }
+inline bool bigint_int_neg(unsigned) { return false; }
+inline bool bigint_int_neg(unsigned long) { return false; }
+inline bool bigint_int_neg(bigint_ullong_t) { return false; }
+inline uint64_t bigint_int_abs(int n) { return n < 0 ? 0 - (uint64_t)n : (uint64_t)n; }
+inline uint64_t bigint_int_abs(long n) { return n < 0 ? 0 - (uint64_t)n : (uint64_t)n; }
+inline uint64_t bigint_int_abs(bigint_llong_t n) { return n < 0 ? 0 - (uint64_t)n : (uint64_t)n; }
+inline uint64_t bigint_int_abs(unsigned n) { return n; }
+inline uint64_t bigint_int_abs(unsigned long n) { return n; }
+inline uint64_t bigint_int_abs(bigint_ullong_t n) { return n; }
+
+// operators with a machine integer, the class provides the raw_*_small kernels.
+// BIGINT_ALL_INT_OPERATORS covers the built-in types from int up, the smaller ones are promoted
+#define BIGINT_INT_OPERATORS(T, I)                                                                  \
+    T &operator+=(I n) { return raw_add_small(bigint_int_neg(n), bigint_int_abs(n)); }              \
+    T &operator-=(I n) { return raw_add_small(!bigint_int_neg(n), bigint_int_abs(n)); }             \
+    T &operator*=(I n) { return raw_mul_small(bigint_int_neg(n), bigint_int_abs(n)); }              \
+    T &operator/=(I n) { return raw_div_small(bigint_int_neg(n), bigint_int_abs(n)); }              \
+    T &operator%=(I n) { return raw_mod_small(bigint_int_abs(n)); }                                 \
+    T operator+(I n) const {                                                                        \
+        T r = *this;                                                                                \
+        return BIGINT_STD_MOVE(r += n);                                                             \
+    }                                                                                               \
+    T operator-(I n) const {                                                                        \
+        T r = *this;                                                                                \
+        return BIGINT_STD_MOVE(r -= n);                                                             \
+    }                                                                                               \
+    T operator*(I n) const {                                                                        \
+        T r = *this;                                                                                \
+        return BIGINT_STD_MOVE(r *= n);                                                             \
+    }                                                                                               \
+    T operator/(I n) const {                                                                        \
+        T r = *this;                                                                                \
+        return BIGINT_STD_MOVE(r /= n);                                                             \
+    }                                                                                               \
+    T operator%(I n) const {                                                                        \
+        T r = *this;                                                                                \
+        return BIGINT_STD_MOVE(r %= n);                                                             \
+    }                                                                                               \
+    bool operator<(I n) const { return raw_cmp_small(bigint_int_neg(n), bigint_int_abs(n)) < 0; }  \
+    bool operator>(I n) const { return raw_cmp_small(bigint_int_neg(n), bigint_int_abs(n)) > 0; }  \
+    bool operator<=(I n) const { return raw_cmp_small(bigint_int_neg(n), bigint_int_abs(n)) <= 0; } \
+    bool operator>=(I n) const { return raw_cmp_small(bigint_int_neg(n), bigint_int_abs(n)) >= 0; } \
+    bool operator==(I n) const { return raw_cmp_small(bigint_int_neg(n), bigint_int_abs(n)) == 0; } \
+    bool operator!=(I n) const { return raw_cmp_small(bigint_int_neg(n), bigint_int_abs(n)) != 0; }
+#define BIGINT_ALL_INT_OPERATORS(T)          \
+    BIGINT_INT_OPERATORS(T, int)             \
+    BIGINT_INT_OPERATORS(T, long)            \
+    BIGINT_INT_OPERATORS(T, bigint_llong_t)  \
+    BIGINT_INT_OPERATORS(T, unsigned)        \
+    BIGINT_INT_OPERATORS(T, unsigned long)   \
+    BIGINT_INT_OPERATORS(T, bigint_ullong_t)
+
+#ifndef BIGINT_INLINE_LIMBS
+#define BIGINT_INLINE_LIMBS 4
+#endif
+
+// define BIGINT_COW 1 to share heap limb buffers between copies, a copy is cloned on its first write
+#ifndef BIGINT_COW
+#define BIGINT_COW 0
+#endif
+#if BIGINT_COW
+#include <new>
+#if BIGINT_THREADS
+#include <atomic>
+typedef std::atomic<size_t> bigint_refcount_t;
+#else
+typedef size_t bigint_refcount_t;
+#endif
+#endif
+
+// bump allocator for limb buffers, everything is freed at once when it is destroyed.
+// blocks are rounded to powers of 2 and the released ones are kept in free lists for reuse.
+// only the numbers constructed with the arena take their buffers from it, copies and moves of
+// them take the heap, so a value returned or stored out of the scope stays valid. the numbers
+// on the arena must stay on one thread and must not outlive it
+class BigIntArena {
+    std::vector<char *> chunks;
+    char *cur;
+    size_t left, chunk_size;
+    void *free_list[64];
+    static size_t size_class(size_t n) {
+        size_t c = 4;
+        while (((size_t)1 << c) < n)
+            ++c;
+        return c;
+    }
+    BigIntArena(const BigIntArena &);
+    BigIntArena &operator=(const BigIntArena &);
+
+public:
+    explicit BigIntArena(size_t chunk_size = (size_t)1 << 20) : cur(0), left(0), chunk_size(chunk_size) {
+        std::fill(free_list, free_list + 64, (void *)0);
+    }
+    ~BigIntArena() { release(); }
+    void *allocate(size_t n) {
+        size_t c = size_class(n);
+        if (free_list[c]) {
+            void *r = free_list[c];
+            free_list[c] = *(void **)r;
+            return r;
+        }
+        n = (size_t)1 << c;
+        if (n > left) {
+            if (n > chunk_size / 4) {
+                chunks.push_back(new char[n]);
+                return chunks.back();
+            }
+            chunks.push_back(cur = new char[chunk_size]);
+            left = chunk_size;
+        }
+        void *r = cur;
+        cur += n;
+        left -= n;
+        return r;
+    }
+    void deallocate(void *p, size_t n) {
+        size_t c = size_class(n);
+        *(void **)p = free_list[c];
+        free_list[c] = p;
+    }
+    void release() {
+        for (size_t i = 0; i < chunks.size(); ++i)
+            delete[] chunks[i];
+        chunks.clear();
+        cur = 0;
+        left = 0;
+        std::fill(free_list, free_list + 64, (void *)0);
+    }
+};
+
+// limb storage like std::vector, but up to N limbs are kept inline without touching the heap.
+// the buffer comes from the heap, or from the arena given to the constructor,
+// the copy and move constructors take the heap.
+// with BIGINT_COW the heap buffers carry a reference count in front of the limbs
+template <class T, size_t N> class BigIntLimbs {
+    T *p;
+    size_t n, cap;
+    BigIntArena *owner;
+    T buf[N];
+#if BIGINT_COW
+    bigint_refcount_t &refs() const { return *(bigint_refcount_t *)((char *)p - sizeof(bigint_refcount_t)); }
+    bool shared() const { return p != buf && !owner && refs() > 1; }
+    T *allocate(size_t c) {
+        if (owner) return (T *)owner->allocate(c * sizeof(T));
+        char *m = new char[sizeof(bigint_refcount_t) + c * sizeof(T)];
+        new (m) bigint_refcount_t(1);
+        return (T *)(m + sizeof(bigint_refcount_t));
+    }
+    void free_buffer() {
+        if (p == buf) return;
+        if (owner) {
+            owner->deallocate(p, cap * sizeof(T));
+        } else if (--refs() == 0) {
+            typedef bigint_refcount_t refcount_t;
+            refs().~refcount_t();
+            delete[]((char *)p - sizeof(bigint_refcount_t));
+        }
+    }
+#else
+    bool shared() const { return false; }
+    T *allocate(size_t c) { return owner ? (T *)owner->allocate(c * sizeof(T)) : new T[c]; }
+    void free_buffer() {
+        if (p == buf) return;
+        if (owner)
+            owner->deallocate(p, cap * sizeof(T));
+        else
+            delete[] p;
+    }
+#endif
+    void reallocate(size_t c) {
+        T *q = allocate(c);
+        std::copy(p, p + n, q);
+        free_buffer();
+        p = q;
+        cap = c;
+    }
+    // copy b, or with BIGINT_COW take another reference to its heap buffer
+    void copy_from(const BigIntLimbs &b) {
+#if BIGINT_COW
+        if (b.p != b.buf && !b.owner && !owner) {
+            ++b.refs();
+            free_buffer();
+            p = b.p;
+            cap = b.cap;
+            n = b.n;
+            return;
+        }
+#endif
+        assign(b.begin(), b.end());
+    }
+    void grow(size_t k) {
+        if (k > cap)
+            reallocate(std::max(k, cap * 2));
+        else
+            unshare();
+    }
+    // take the content of b and leave it empty, buffers only change hands within the same arena
+    void steal(BigIntLimbs &b) {
+        if (b.p != b.buf && b.owner == owner) {
+            free_buffer();
+            p = b.p;
+            cap = b.cap;
+            n = b.n;
+        } else {
+            assign(b.begin(), b.end());
+            b.free_buffer();
+        }
+        b.p = b.buf;
+        b.cap = N;
+        b.n = 0;
+    }
+
+public:
+    typedef T value_type;
+    typedef T *iterator;
+    typedef const T *const_iterator;
+    BigIntLimbs() : p(buf), n(0), cap(N), owner(0) {}
+    explicit BigIntLimbs(BigIntArena &arena) : p(buf), n(0), cap(N), owner(&arena) {}
+    explicit BigIntLimbs(size_t k, const T &x = T()) : p(buf), n(0), cap(N), owner(0) { assign(k, x); }
+    BigIntLimbs(const BigIntLimbs &b) : p(buf), n(0), cap(N), owner(0) { copy_from(b); }
+    ~BigIntLimbs() { free_buffer(); }
+    BigIntLimbs &operator=(const BigIntLimbs &b) {
+        if (this != &b) copy_from(b);
+        return *this;
+    }
+#if BIGINT_RVALUE_REF
+    BigIntLimbs(BigIntLimbs &&b) : p(buf), n(0), cap(N), owner(0) { steal(b); }
+    BigIntLimbs &operator=(BigIntLimbs &&b) {
+        if (this != &b) steal(b);
+        return *this;
+    }
+#endif
+    size_t size() const { return n; }
+    size_t capacity() const { return cap; }
+    bool empty() const { return n == 0; }
+    // make the buffer private, a mutating operation does it once before writing through
+    // operator[], front() or back(). begin(), resize() and the growing calls do it too
+    void unshare() {
+        if (shared()) reallocate(cap);
+    }
+    // plain accesses, with BIGINT_COW they are read-only until the buffer is made private
+    T &operator[](size_t i) { return p[i]; }
+    const T &operator[](size_t i) const { return p[i]; }
+    T *begin() {
+        unshare();
+        return p;
+    }
+    T *end() { return begin() + n; }
+    const T *begin() const { return p; }
+    const T *end() const { return p + n; }
+    T &front() { return p[0]; }
+    T &back() { return p[n - 1]; }
+    const T &front() const { return p[0]; }
+    const T &back() const { return p[n - 1]; }
+    void reserve(size_t k) {
+        if (k > cap) reallocate(k);
+    }
+    void clear() { n = 0; }
+    void resize(size_t k, const T &x = T()) {
+        if (k > n) {
+            T t = x;
+            grow(k);
+            std::fill(p + n, p + k, t);
+        } else {
+            unshare();
+        }
+        n = k;
+    }
+    void assign(size_t k, const T &x) {
+        n = 0;
+        resize(k, x);
+    }
+    template <class U> void assign(const U *first, const U *last) {
+        size_t k = (size_t)(last - first);
+        if (k > cap || shared()) {
+            // the old buffer may hold the range, so it is freed after the copy
+            T *q = k > N ? allocate(k) : buf;
+            std::copy(first, last, q);
+            free_buffer();
+            p = q;
+            cap = std::max(k, N);
+            n = k;
+            return;
+        }
+        // a range inside the own buffer only moves down
+        std::copy(first, last, p);
+        n = k;
+    }
+    void push_back(const T &x) {
+        T t = x;
+        grow(n + 1);
+        p[n++] = t;
+    }
+    void pop_back() { --n; }
+    T *erase(T *first, T *last) {
+        // the iterators come from begin(), which already made the buffer private
+        std::copy(last, p + n, first);
+        n -= last - first;
+        return first;
+    }
+    void insert(T *pos, size_t k, const T &x) {
+        size_t i = pos - p;
+        T t = x;
+        grow(n + k);
+        std::copy_backward(p + i, p + n, p + n + k);
+        std::fill(p + i, p + i + k, t);
+        n += k;
+    }
+    void swap(BigIntLimbs &b) {
+        BigIntLimbs t;
+        t.owner = owner;
+        t.steal(*this);
+        steal(b);
+        b.steal(t);
+    }
+};
+
+// read-only window on the limbs of a number or on a range of them. the raw kernels take it
+// so that the parts of a number are used in place instead of being copied out
+template <class T> struct BigIntLimbView {
+    const T *v;
+    size_t n;
+    int sign;
+    BigIntLimbView(const T *v, size_t n, int sign = 1) : v(v), n(n), sign(sign) {}
+    size_t size() const { return n; }
+    bool is_zero() const { return n == 1 && v[0] == 0; }
+    // equal magnitudes
+    bool operator==(const BigIntLimbView &b) const { return n == b.n && (v == b.v || std::equal(v, v + n, b.v)); }
+    // the limbs from k up
+    BigIntLimbView shr(size_t k) const {
+        static const T zero = 0;
+        if (k >= n) return BigIntLimbView(&zero, 1);
+        return BigIntLimbView(v + k, n - k);
+    }
+    // the low k limbs without the leading zeros
+    BigIntLimbView low(size_t k) const {
+        if (k >= n) return *this;
+        while (k > 1 && v[k - 1] == 0)
+            --k;
+        return k ? BigIntLimbView(v, k) : shr(n);
+    }
+};
@@ -23,8 +23,11 @@ const uint32_t COMPRESS_MASK = COMPRESS_MOD - 1;
 
 const uint32_t BIGINT_NTT_THRESHOLD = BIGINT_X64 ? 2000 : 1900;
 const uint32_t BIGINT_MUL_THRESHOLD = BIGINT_X64 ? 110 : 100;
+const uint32_t BIGINT_COMBA_THRESHOLD = 10;
 const uint32_t BIGINT_DIV_THRESHOLD = 1500;
 const uint32_t BIGINT_DIVIDEDIV_THRESHOLD = BIGINT_MUL_THRESHOLD * 3;
+const uint32_t BIGINT_HGCD_THRESHOLD = 400;
+const uint32_t BIGINT_GCD_THRESHOLD = 800;
 #if BIGINT_X64
 const uint32_t NTT_MAX_SIZE = 1 << (23 + BIGINTHEX_DIV_DOUBLE);
 #else
@@ -38,14 +41,37 @@ template <typename T> inline uint32_t low_digit(T digit) { return (uint32_t)(dig
 template <typename T> inline uint32_t low_digit(T digit) { return (uint32_t)digit; }
 #endif
 
+class BigIntHexMont;
+class BigIntHexBarrett;
+class BigIntHexPowTable;
+class BigIntHexGcd;
+template <class Gen> class BigIntHexBinarySplit;
+class BigIntHexPrime;
+template <size_t BITS> class BigIntHexFixed;
+class BigIntHexAccum;
+
 class BigIntHex {
 protected:
     typedef uint32_t base_t;
+    typedef BigIntLimbView<base_t> view_t;
     typedef int64_t carry_t;
     typedef uint64_t ucarry_t;
     int sign;
-    std::vector<base_t> v;
+    BigIntLimbs<base_t, BIGINT_INLINE_LIMBS> v;
     typedef BigIntHex BigInt_t;
+    friend class BigIntHexMont;
+    friend class BigIntHexBarrett;
+    friend class BigIntHexPowTable;
+    friend class BigIntHexGcd;
+    template <class Gen> friend class BigIntHexBinarySplit;
+    friend class BigIntHexPrime;
+    template <size_t BITS> friend class BigIntHexFixed;
+    friend class BigIntHexAccum;
+    friend BigInt_t isqrt_rem(const BigInt_t &a, BigInt_t &r);
+    friend BigInt_t iroot(const BigInt_t &a, uint32_t k);
+    friend BigInt_t tdiv_r_2exp(const BigInt_t &a, uint64_t n);
+    friend BigInt_t dot(const std::vector<BigInt_t> &a, const std::vector<BigInt_t> &b);
+    friend std::vector<BigInt_t> poly_mul(const std::vector<BigInt_t> &a, const std::vector<BigInt_t> &b);
     template <typename _Tx, typename _Ty> static inline void carry(_Tx &add, _Ty &baseval, _Tx newval) {
         add += newval;
         baseval = low_digit(add);
@@ -57,6 +83,13 @@ protected:
         add = high_digit(add);
     }
 
+    operator view_t() const { return raw_view(); }
+    view_t raw_view() const { return view_t(&v[0], size(), sign); }
+    BigInt_t &raw_assign(const view_t &a) {
+        v.assign(a.v, a.v + a.size());
+        sign = a.sign;
+        return *this;
+    }
     bool raw_less(const BigInt_t &b) const {
         if (v.size() != b.size()) return v.size() < b.size();
         for (size_t i = v.size() - 1; i < v.size(); i--)
@@ -70,17 +103,19 @@ protected:
             if (v[i] != b.v[i]) return false;
         return true;
     }
-    BigInt_t &raw_add(const BigInt_t &b) {
+    BigInt_t &raw_add(const view_t &b) {
+        v.unshare();
         if (v.size() < b.size()) v.resize(b.size());
         ucarry_t add = 0;
-        for (size_t i = 0; i < b.v.size(); i++)
+        for (size_t i = 0; i < b.size(); i++)
             carry(add, v[i], (ucarry_t)v[i] + b.v[i]);
-        for (size_t i = b.v.size(); add && i < v.size(); i++)
+        for (size_t i = b.size(); add && i < v.size(); i++)
             carry(add, v[i], (ucarry_t)v[i]);
         add ? v.push_back((base_t)add) : trim();
         return *this;
     }
     BigInt_t &raw_offset_add(const BigInt_t &b, size_t offset) {
+        v.unshare();
         ucarry_t add = 0;
         for (size_t i = 0; i < b.size(); ++i)
             carry(add, v[i + offset], (ucarry_t)v[i + offset] + b.v[i]);
@@ -89,6 +124,7 @@ protected:
         return *this;
     }
     BigInt_t &raw_sub(const BigInt_t &b) {
+        v.unshare();
         if (v.size() < b.v.size()) v.resize(b.v.size());
         carry_t add = 0;
         for (size_t i = 0; i < b.v.size(); i++)
@@ -102,9 +138,11 @@ protected:
                 carry(add, v[i], (carry_t)(COMPRESS_MOD - v[i] - 1));
         }
         trim();
+        if (is_zero()) sign = 1;
         return *this;
     }
     BigInt_t &raw_offset_sub(const BigInt_t &b, size_t offset) {
+        v.unshare();
         carry_t add = 0;
         for (size_t i = 0; i < b.v.size(); i++)
             borrow(add, v[i + offset], (carry_t)v[i + offset] - (carry_t)b.v[i]);
@@ -114,6 +152,7 @@ protected:
     }
     BigInt_t &raw_offset_mulsub(const BigInt_t &b, base_t mul, size_t offset) {
         if (mul == 0) return *this;
+        v.unshare();
         carry_t add = 0;
         for (size_t i = 0; i < b.v.size(); i++)
             borrow(add, v[i + offset], (carry_t)v[i + offset] - (carry_t)b.v[i] * (carry_t)mul);
@@ -127,6 +166,7 @@ protected:
             return *this;
         } else if (m == 1)
             return *this;
+        v.unshare();
         ucarry_t add = 0;
         size_t i = 0;
         for (; i + 4 <= v.size(); i += 4) {
@@ -144,32 +184,72 @@ protected:
         if (add) v.push_back((base_t)add);
         return *this;
     }
-    BigInt_t &raw_mul(const BigInt_t &a, const BigInt_t &b) {
+    // comba multiplication of n x n limbs, unrolled at compile time for each n.
+    // the low and high halves of the products in a column are summed apart, so the sums can not overflow
+    template <size_t I> struct idx {};
+    // the terms a[I] * b[K - I] of column K for I up to E
+    template <size_t K, size_t I, size_t E> struct comba_col {
+        static BIGINT_FORCEINLINE void run(const base_t *a, const base_t *b, ucarry_t &lo, ucarry_t &hi) {
+            ucarry_t p = (ucarry_t)a[I] * b[K - I];
+            lo += low_digit(p);
+            hi += high_digit(p);
+            comba_col<K, I + 1, E>::run(a, b, lo, hi);
+        }
+    };
+    template <size_t K, size_t E> struct comba_col<K, E, E> {
+        static BIGINT_FORCEINLINE void run(const base_t *, const base_t *, ucarry_t &, ucarry_t &) {}
+    };
+    // the columns from K = 2N - 1 - R up
+    template <size_t N, size_t R> struct comba {
+        static const size_t K = 2 * N - 1 - R;
+        static BIGINT_FORCEINLINE void run(base_t *r, const base_t *a, const base_t *b, ucarry_t add) {
+            ucarry_t lo = add, hi = 0;
+            comba_col<K, (K < N ? 0 : K - N + 1), (K < N ? K + 1 : N)>::run(a, b, lo, hi);
+            r[K] = low_digit(lo);
+            comba<N, R - 1>::run(r, a, b, high_digit(lo) + hi);
+        }
+    };
+    template <size_t N> struct comba<N, 0> {
+        static BIGINT_FORCEINLINE void run(base_t *r, const base_t *, const base_t *, ucarry_t add) { r[2 * N - 1] = low_digit(add); }
+    };
+    // r[0..2n) = a[0..n) * b[0..n) with the kernel for n, n <= I
+    template <size_t I> static void raw_comba(base_t *r, const base_t *a, const base_t *b, size_t n, idx<I>) {
+        if (n < I) return raw_comba(r, a, b, n, idx<I - 1>());
+        comba<I, 2 * I - 1>::run(r, a, b, 0);
+    }
+    static void raw_comba(base_t *, const base_t *, const base_t *, size_t, idx<0>) {}
+    BigInt_t &raw_mul(const view_t &a, const view_t &b) {
         if (a.is_zero() || b.is_zero()) {
             return set(0);
         }
         if (a.size() == 1 && a.v[0] == 1) {
-            *this = b;
+            raw_assign(b);
             sign *= a.sign;
             return *this;
         }
         if (b.size() == 1 && b.v[0] == 1) {
-            *this = a;
+            raw_assign(a);
             sign *= b.sign;
             return *this;
         }
         if (a.size() == 2 && a.v[1] == 1 && a.v[0] == 0) {
-            *this = b;
+            raw_assign(b);
             raw_shl(1);
             sign *= a.sign;
             return *this;
         }
         if (b.size() == 2 && b.v[1] == 1 && b.v[0] == 0) {
-            *this = a;
+            raw_assign(a);
             raw_shl(1);
             sign *= b.sign;
             return *this;
         }
+        if (a.size() == b.size() && a.size() <= BIGINT_COMBA_THRESHOLD) {
+            v.resize(a.size() * 2);
+            raw_comba(&v[0], a.v, b.v, a.size(), idx<BIGINT_COMBA_THRESHOLD>());
+            trim();
+            return *this;
+        }
         v.clear();
         v.resize(a.size() + b.size());
         for (size_t i = 0; i < a.size(); i++) {
@@ -201,8 +281,40 @@ protected:
         trim();
         return *this;
     }
+    // adds |a| * |b| to the magnitude, the schoolbook rows go straight into the limbs
+    BigInt_t &raw_muladd(const BigInt_t &a, const BigInt_t &b) {
+        const BigInt_t &x = a.size() < b.size() ? a : b, &y = a.size() < b.size() ? b : a;
+        v.resize(std::max(size(), x.size() + y.size()) + 1);
+        for (size_t i = 0; i < x.size(); i++) {
+            ucarry_t add = 0, xv = x.v[i];
+            if (xv == 0) continue;
+            for (size_t j = 0; j < y.size(); ++j)
+                carry(add, v[i + j], v[i + j] + xv * y.v[j]);
+            for (size_t j = i + y.size(); add; ++j)
+                carry(add, v[j], (ucarry_t)v[j]);
+        }
+        trim();
+        return *this;
+    }
+    // *this += s * a * b
+    BigInt_t &raw_addmul(const BigInt_t &a, const BigInt_t &b, int s) {
+        if (a.is_zero() || b.is_zero()) return *this;
+        int ps = a.sign * b.sign * s;
+        if (this != &a && this != &b && (is_zero() || sign == ps) &&
+            (a.size() == 1 || b.size() == 1 || a.size() + b.size() <= BIGINT_MUL_THRESHOLD * 2)) {
+            if (is_zero()) sign = ps;
+            return raw_muladd(a, b);
+        }
+        BigInt_t t = a * b;
+        if (is_zero()) {
+            v.swap(t.v);
+            sign = ps;
+            return *this;
+        }
+        return s > 0 ? *this += t : *this -= t;
+    }
     // Karatsuba algorithm
-    BigInt_t &raw_mul_karatsuba(const BigInt_t &a, const BigInt_t &b) {
+    BigInt_t &raw_mul_karatsuba(const view_t &a, const view_t &b) {
         if (std::min(a.size(), b.size()) <= BIGINT_MUL_THRESHOLD) {
             return raw_mul(a, b);
         }
@@ -210,15 +322,15 @@ protected:
             BigInt_t t;
             if (a.size() < b.size()) {
                 size_t split = b.size() / 2;
-                t.raw_mul_karatsuba(a, b.raw_shr_to(split));
+                t.raw_mul_karatsuba(a, b.shr(split));
                 t.raw_shl(split);
-                raw_mul_karatsuba(a, b.raw_lowdigits_to(split));
+                raw_mul_karatsuba(a, b.low(split));
                 raw_add(t);
             } else {
                 size_t split = a.size() / 2;
-                t.raw_mul_karatsuba(b, a.raw_shr_to(split));
+                t.raw_mul_karatsuba(b, a.shr(split));
                 t.raw_shl(split);
-                raw_mul_karatsuba(b, a.raw_lowdigits_to(split));
+                raw_mul_karatsuba(b, a.low(split));
                 raw_add(t);
             }
             return *this;
@@ -227,16 +339,15 @@ protected:
             ;
         else if ((a.size() + b.size()) <= NTT_MAX_SIZE)
             return raw_nttmul(a, b);
-        BigInt_t ah, al, bh, bl, h, m;
+        BigInt_t h, m, sa, sb;
         size_t split = std::max(std::min((a.size() + 1) / 2, b.size() - 1), std::min(a.size() - 1, (b.size() + 1) / 2));
-        al.v.assign(a.v.begin(), a.v.begin() + split);
-        ah.v.assign(a.v.begin() + split, a.v.end());
-        bl.v.assign(b.v.begin(), b.v.begin() + split);
-        bh.v.assign(b.v.begin() + split, b.v.end());
+        view_t al = a.low(split), ah = a.shr(split), bl = b.low(split), bh = b.shr(split);
 
         raw_mul_karatsuba(al, bl);
         h.raw_mul_karatsuba(ah, bh);
-        m.raw_mul_karatsuba(al + ah, bl + bh);
+        sa.raw_assign(al).raw_add(ah);
+        sb.raw_assign(bl).raw_add(bh);
+        m.raw_mul_karatsuba(sa, sb);
         m.raw_sub(*this);
         m.raw_sub(h);
         v.resize(a.size() + b.size());
@@ -246,7 +357,7 @@ protected:
         trim();
         return *this;
     }
-    BigInt_t &raw_nttmul(const BigInt_t &a, const BigInt_t &b) {
+    BigInt_t &raw_nttmul(const view_t &a, const view_t &b) {
         if (std::min(a.size(), b.size()) <= BIGINT_MUL_THRESHOLD) {
             return raw_mul(a, b);
         }
@@ -257,22 +368,23 @@ protected:
             BigInt_t t;
             if (a.size() < b.size()) {
                 size_t split = b.size() / 2;
-                t.raw_nttmul(a, b.raw_shr_to(split));
+                t.raw_nttmul(a, b.shr(split));
                 t.raw_shl(split);
-                raw_nttmul(a, b.raw_lowdigits_to(split));
+                raw_nttmul(a, b.low(split));
                 raw_add(t);
             } else {
                 size_t split = a.size() / 2;
-                t.raw_nttmul(b, a.raw_shr_to(split));
+                t.raw_nttmul(b, a.shr(split));
                 t.raw_shl(split);
-                raw_nttmul(b, a.raw_lowdigits_to(split));
+                raw_nttmul(b, a.low(split));
                 raw_add(t);
             }
             return *this;
         }
         size_t len, lenmul = 2;
-        std::vector<NTT_NS::ntt_base_t> &ntt_a = NTT_NS::ntt1.ntt_a, &ntt_b = NTT_NS::ntt1.ntt_b;
-        std::vector<int64_t> &ntt_c = NTT_NS::ntt1.ntt_c;
+        NTT_NS::NTTBuffers &nb = NTT_NS::ntt_buffers;
+        std::vector<NTT_NS::ntt_base_t> &ntt_a = nb.ntt1.ntt_a, &ntt_b = nb.ntt1.ntt_b;
+        std::vector<int64_t> &ntt_c = nb.ntt1.ntt_c;
         ntt_a.resize(a.size() * 2);
         ntt_b.resize(b.size() * 2);
         for (size_t i = 0, j = 0; i < a.size(); ++i, ++j) {
@@ -280,16 +392,16 @@ protected:
             ntt_a[++j] = a.v[i] >> COMPRESS_HALF_BIT;
         }
         if (a == b) {
-            NTT_NS::ntt_prepare(a.size() * 2, a.size() * 2, len, 7);
-            NTT_NS::sqr_conv();
+            NTT_NS::ntt_prepare(nb, a.size() * 2, a.size() * 2, len, 7);
+            NTT_NS::sqr_conv(nb);
             len = a.size() * 2 * lenmul;
         } else {
             for (size_t i = 0, j = 0; i < b.size(); ++i, ++j) {
                 ntt_b[j] = b.v[i] & COMPRESS_HALF_MASK;
                 ntt_b[++j] = b.v[i] >> COMPRESS_HALF_BIT;
             }
-            NTT_NS::ntt_prepare(a.size() * 2, b.size() * 2, len, 7);
-            NTT_NS::mul_conv();
+            NTT_NS::ntt_prepare(nb, a.size() * 2, b.size() * 2, len, 7);
+            NTT_NS::mul_conv(nb);
             len = (a.size() + b.size()) * lenmul;
         }
         while (len > 0 && ntt_c[--len] == 0)
@@ -307,6 +419,146 @@ protected:
         trim();
         return *this;
     }
+    // *this = a[0] * b[0] + a[1] * b[1] + ..., the large products with the same sign and transform length
+    // are summed in the transform domain, so that a group needs only one inverse transform and carry pass
+    BigInt_t &raw_dot(const std::vector<BigInt_t> &a, const std::vector<BigInt_t> &b) {
+        std::vector<std::pair<size_t, size_t> > group[2]; // the transform length and the index, by sign
+        BigInt_t sum[2], t;
+        for (size_t i = 0; i < std::min(a.size(), b.size()); ++i) {
+            const BigInt_t &x = a[i], &y = b[i];
+            if (x.is_zero() || y.is_zero()) continue;
+            int s = x.sign != y.sign;
+            if (std::min(x.size(), y.size()) <= BIGINT_NTT_THRESHOLD || x.size() + y.size() > NTT_MAX_SIZE) {
+                t.raw_nttmul(x, y);
+                sum[s].raw_add(t);
+                continue;
+            }
+            size_t len = 1;
+            while (len < (x.size() + y.size()) * 2)
+                len <<= 1;
+            group[s].push_back(std::make_pair(len, i));
+        }
+        // a column of a product is a sum of at most min(x.size(), y.size()) * 2 terms
+        const uint64_t limit = (uint64_t)NTT_NS::NTT_P1 * NTT_NS::NTT_P2;
+        const uint64_t term = (uint64_t)COMPRESS_HALF_MASK * COMPRESS_HALF_MASK * 2;
+        NTT_NS::NTTBuffers &nb = NTT_NS::ntt_buffers;
+        std::vector<NTT_NS::ntt_base_t> &ntt_a = nb.ntt1.ntt_a, &ntt_b = nb.ntt1.ntt_b;
+        std::vector<int64_t> &ntt_c = nb.ntt1.ntt_c;
+        for (int s = 0; s < 2; ++s) {
+            std::sort(group[s].begin(), group[s].end());
+            for (size_t j = 0; j < group[s].size();) {
+                size_t len = group[s][j].first;
+                uint64_t bound = 0;
+                NTT_NS::dot_prepare(nb, len);
+                for (; j < group[s].size() && group[s][j].first == len; ++j) {
+                    const BigInt_t &x = a[group[s][j].second], &y = b[group[s][j].second];
+                    uint64_t col = term * std::min(x.size(), y.size());
+                    if (bound > limit - col) break;
+                    bound += col;
+                    bool sqr = x.raw_view() == y.raw_view();
+                    ntt_a.resize(x.size() * 2);
+                    for (size_t i = 0, k = 0; i < x.size(); ++i, ++k) {
+                        ntt_a[k] = x.v[i] & COMPRESS_HALF_MASK;
+                        ntt_a[++k] = x.v[i] >> COMPRESS_HALF_BIT;
+                    }
+                    if (!sqr) {
+                        ntt_b.resize(y.size() * 2);
+                        for (size_t i = 0, k = 0; i < y.size(); ++i, ++k) {
+                            ntt_b[k] = y.v[i] & COMPRESS_HALF_MASK;
+                            ntt_b[++k] = y.v[i] >> COMPRESS_HALF_BIT;
+                        }
+                    }
+                    NTT_NS::ntt_prepare_cyclic(nb, len, sqr ? 2 : 7);
+                    NTT_NS::dot_add(nb, sqr);
+                }
+                NTT_NS::dot_conv(nb);
+                t.v.resize(len / 2 + 1);
+                uint64_t add = 0;
+                for (size_t i = 0; i < len; i += 2) {
+                    add += ntt_c[i] + ((ntt_c[i + 1] & COMPRESS_HALF_MASK) << COMPRESS_HALF_BIT);
+                    t.v[i / 2] = low_digit(add);
+                    add = high_digit(add) + (ntt_c[i + 1] >> COMPRESS_HALF_BIT);
+                }
+                t.v.back() = (base_t)add;
+                t.trim();
+                sum[s].raw_add(t);
+            }
+        }
+        *this = sum[0];
+        return raw_sub(sum[1]);
+    }
+    // wrap-around product, *this = a * b mod (COMPRESS_MOD^n - 1)
+    // it only needs a cyclic convolution of length 2n, so n should be a power of 2
+    BigInt_t &raw_nttmul_wrap(const BigInt_t &a, const BigInt_t &b, size_t n) {
+        if (std::min(a.size(), b.size()) <= BIGINT_NTT_THRESHOLD || n * 2 > NTT_MAX_SIZE || (n & (n - 1))) {
+            raw_nttmul(a, b);
+            while (size() > n) {
+                BigInt_t h = raw_shr_to(n);
+                v.resize(n);
+                trim();
+                raw_add(h);
+            }
+            return *this;
+        }
+        NTT_NS::NTTBuffers &nb = NTT_NS::ntt_buffers;
+        std::vector<NTT_NS::ntt_base_t> &ntt_a = nb.ntt1.ntt_a, &ntt_b = nb.ntt1.ntt_b;
+        std::vector<int64_t> &ntt_c = nb.ntt1.ntt_c;
+        ntt_a.resize(a.size() * 2);
+        ntt_b.resize(b.size() * 2);
+        for (size_t i = 0, j = 0; i < a.size(); ++i, ++j) {
+            ntt_a[j] = a.v[i] & COMPRESS_HALF_MASK;
+            ntt_a[++j] = a.v[i] >> COMPRESS_HALF_BIT;
+        }
+        for (size_t i = 0, j = 0; i < b.size(); ++i, ++j) {
+            ntt_b[j] = b.v[i] & COMPRESS_HALF_MASK;
+            ntt_b[++j] = b.v[i] >> COMPRESS_HALF_BIT;
+        }
+        NTT_NS::ntt_prepare_cyclic(nb, n * 2, 7);
+        NTT_NS::mul_conv(nb);
+        v.resize(n);
+        uint64_t add = 0;
+        for (size_t i = 0; i < n; ++i) {
+            add += ntt_c[i * 2] + ((ntt_c[i * 2 + 1] & COMPRESS_HALF_MASK) << COMPRESS_HALF_BIT);
+            v[i] = low_digit(add);
+            add = high_digit(add) + (ntt_c[i * 2 + 1] >> COMPRESS_HALF_BIT);
+        }
+        // COMPRESS_MOD^n = 1, the carry goes around to the lowest limb
+        for (size_t i = 0; add; i = (i + 1) % n)
+            carry(add, v[i], (uint64_t)v[i]);
+        trim();
+        return *this;
+    }
+    // short product, *this = a * b / COMPRESS_MOD^n, the low columns are skipped
+    // so the result may be 1 less than the exact one
+    BigInt_t &raw_mul_high(const BigInt_t &a, const BigInt_t &b, size_t n) {
+        const BigInt_t &x = a.size() < b.size() ? b : a, &y = a.size() < b.size() ? a : b;
+        if (n >= x.size() + y.size()) return set(0);
+        if (y.size() <= BIGINT_MUL_THRESHOLD) {
+            // keep 2 guard columns, the dropped ones are less than y.size() / COMPRESS_MOD
+            size_t lo = n < 2 ? 0 : n - 2;
+            v.assign(x.size() + y.size() - lo, 0);
+            for (size_t i = 0; i < y.size(); i++) {
+                ucarry_t add = 0, yv = y.v[i];
+                size_t j = lo > i ? lo - i : 0;
+                if (j >= x.size()) continue;
+                for (; j < x.size(); ++j)
+                    carry(add, v[i + j - lo], v[i + j - lo] + yv * x.v[j]);
+                v[i + x.size() - lo] = (base_t)add;
+            }
+            raw_shr(n - lo);
+        } else if (n > y.size() + 1) {
+            // the dropped limbs of x are less than COMPRESS_MOD^(n - 1) in the product
+            size_t k = n - y.size() - 1;
+            raw_nttmul(x.raw_view().shr(k), y);
+            raw_shr(n - k);
+        } else {
+            raw_nttmul(x, y);
+            raw_shr(n);
+        }
+        trim();
+        sign = a.sign * b.sign;
+        return *this;
+    }
     BigInt_t &raw_div(const BigInt_t &a, const BigInt_t &b, BigInt_t &r) {
         r = a;
         if (a.raw_less(b)) {
@@ -356,6 +608,9 @@ protected:
                     if (m >= COMPRESS_MOD) {
                         m >>= COMPRESS_BIT;
                         ++i;
+                    } else {
+                        // the estimate can round down to 0 when the top limbs are close to b
+                        m = std::max(m, (ucarry_t)r.v[i + offset]);
                     }
                 }
             }
@@ -365,7 +620,10 @@ protected:
             r.raw_offset_mulsub(b, (base_t)m, i);
 #else
             if (m) {
-                v[i] += (base_t)m;
+                // the digits use all the bits, carry into the higher ones
+                ucarry_t add = m;
+                for (size_t j = i; add; ++j)
+                    carry(add, v[j], (ucarry_t)v[j]);
                 BigInt_t bm = b;
                 bm.raw_mul_int((base_t)m);
                 r.raw_offset_sub(bm, i);
@@ -384,7 +642,10 @@ protected:
             ucarry_t rm = r.v[i + offset - 1], m = 0;
             m = (rm << (COMPRESS_BIT - 1)) / db;
             if (m) {
-                v[i] += (base_t)m;
+                // the digits use all the bits, carry into the higher ones
+                ucarry_t add = m;
+                for (size_t j = i; add; ++j)
+                    carry(add, v[j], (ucarry_t)v[j]);
                 BigInt_t bm = b;
                 bm.raw_mul_int((base_t)m);
                 r.raw_offset_sub(bm, i);
@@ -415,145 +676,461 @@ protected:
         BigInt_t r;
         if (n >= size()) return r;
         r.v.assign(v.begin() + n, v.end());
-        return BIGINT_STD_MOVE(r);
+        return r;
+    }
+    // the top n limbs, padded with zeros if there are not enough limbs
+    BigInt_t raw_top_to(size_t n) const {
+        if (n <= size()) return raw_shr_to(size() - n);
+        BigInt_t r = *this;
+        r.raw_shl(n - size());
+        return r;
     }
     BigInt_t raw_lowdigits_to(size_t n) const {
         if (n >= size()) return *this;
         BigInt_t r;
         r.v.assign(v.begin(), v.begin() + n);
         r.trim();
-        return BIGINT_STD_MOVE(r);
+        return r;
+    }
+    // the magnitude in 32-bit words from the lowest, for the exponents
+    std::vector<uint32_t> raw_words() const {
+#if BIGINTHEX_DIV_DOUBLE
+        std::vector<uint32_t> w;
+        uint64_t add = 0;
+        uint32_t bits = 0;
+        for (size_t i = 0; i < v.size(); ++i) {
+            add |= (uint64_t)v[i] << bits;
+            bits += COMPRESS_BIT;
+            if (bits >= 32) {
+                w.push_back((uint32_t)add);
+                add >>= 32;
+                bits -= 32;
+            }
+        }
+        if (bits) w.push_back((uint32_t)add);
+        return w;
+#else
+        return std::vector<uint32_t>(v.begin(), v.end());
+#endif
     }
     BigInt_t &raw_shl(size_t n) {
         if (n == 0 || is_zero()) return *this;
-        v.insert(v.begin(), n, 0);
+        size_t s = size();
+        v.resize(s + n);
+        std::copy_backward(v.begin(), v.begin() + s, v.end());
+        std::fill(v.begin(), v.begin() + n, 0);
         return *this;
     }
-    BigInt_t &keep(size_t n) {
-        size_t s = n < v.size() ? v.size() - n : (size_t)0;
-        if (s && v[s - 1] >= COMPRESS_MOD >> 1) ++v[s];
-        return raw_shr(s);
+    // r = |*this| * 2^n in one pass from the top limb down, r may be *this
+    void raw_mul_2exp_to(BigInt_t &r, uint64_t n) const {
+        size_t w = (size_t)(n / COMPRESS_BIT), b = (size_t)(n % COMPRESS_BIT), s = size();
+        if (is_zero()) {
+            r.set(0);
+            return;
+        }
+        r.v.resize(s + w + 1);
+        if (b == 0) {
+            r.v[s + w] = 0;
+            for (size_t i = s; i-- > 0;)
+                r.v[i + w] = v[i];
+        } else {
+            r.v[s + w] = v[s - 1] >> (COMPRESS_BIT - b);
+            for (size_t i = s - 1; i > 0; --i)
+                r.v[i + w] = ((v[i] << b) | (v[i - 1] >> (COMPRESS_BIT - b))) & COMPRESS_MASK;
+            r.v[w] = (v[0] << b) & COMPRESS_MASK;
+        }
+        std::fill(r.v.begin(), r.v.begin() + w, 0);
+        r.trim();
+    }
+    BigInt_t &raw_mul_2exp(uint64_t n) {
+        raw_mul_2exp_to(*this, n);
+        return *this;
+    }
+    // r = |*this| / 2^n rounded toward zero in one pass from the bottom limb up, r may be *this
+    void raw_div_2exp_to(BigInt_t &r, uint64_t n) const {
+        if (n / COMPRESS_BIT >= size()) {
+            r.set(0);
+            return;
+        }
+        size_t w = (size_t)(n / COMPRESS_BIT), b = (size_t)(n % COMPRESS_BIT), s = size() - w;
+        if (&r != this)
+            r.v.resize(s);
+        else
+            r.v.unshare();
+        if (b == 0) {
+            for (size_t i = 0; i < s; ++i)
+                r.v[i] = v[i + w];
+        } else {
+            for (size_t i = 0; i + 1 < s; ++i)
+                r.v[i] = ((v[i + w] >> b) | (v[i + w + 1] << (COMPRESS_BIT - b))) & COMPRESS_MASK;
+            r.v[s - 1] = v[s - 1 + w] >> b;
+        }
+        r.v.resize(s);
+        r.trim();
+    }
+    BigInt_t &raw_div_2exp(uint64_t n) {
+        raw_div_2exp_to(*this, n);
+        return *this;
+    }
+    // |*this| mod 2^n
+    BigInt_t &raw_mod_2exp(uint64_t n) {
+        if (n / COMPRESS_BIT >= size()) return *this;
+        size_t w = (size_t)(n / COMPRESS_BIT), b = (size_t)(n % COMPRESS_BIT);
+        v.resize(w + 1);
+        v[w] &= ((base_t)1 << b) - 1;
+        trim();
+        return *this;
     }
+    // the bitwise operations on the limbs and on the signs
+    struct BitAnd {
+        static base_t op(base_t x, base_t y) { return x & y; }
+        static bool neg(bool x, bool y) { return x && y; }
+    };
+    struct BitOr {
+        static base_t op(base_t x, base_t y) { return x | y; }
+        static bool neg(bool x, bool y) { return x || y; }
+    };
+    struct BitXor {
+        static base_t op(base_t x, base_t y) { return x ^ y; }
+        static bool neg(bool x, bool y) { return x != y; }
+    };
+    // *this = a op b on the two's complement forms, the signs extend to the limbs above them
+    template <class Op> BigInt_t &raw_bitwise(const BigInt_t &a, const BigInt_t &b) {
+        bool na = a.sign < 0 && !a.is_zero(), nb = b.sign < 0 && !b.is_zero();
+        const BigInt_t &x = a.size() < b.size() ? b : a, &y = a.size() < b.size() ? a : b;
+        BigIntLimbs<base_t, BIGINT_INLINE_LIMBS> r;
+        if (!na && !nb) {
+            // plain loops for the common case
+            r.resize(x.size());
+            for (size_t i = 0; i < y.size(); ++i)
+                r[i] = Op::op(x.v[i], y.v[i]);
+            for (size_t i = y.size(); i < x.size(); ++i)
+                r[i] = Op::op(x.v[i], 0);
+        } else {
+            // one more limb for the carry of -COMPRESS_MOD^n
+            size_t n = x.size() + 1;
+            bool neg = Op::neg(na, nb);
+            ucarry_t ca = na, cb = nb, c = neg;
+            r.resize(n);
+            for (size_t i = 0; i < n; ++i) {
+                ucarry_t p = i < a.size() ? a.v[i] : 0, q = i < b.size() ? b.v[i] : 0;
+                if (na) {
+                    ca += ~p & COMPRESS_MASK;
+                    p = ca & COMPRESS_MASK;
+                    ca >>= COMPRESS_BIT;
+                }
+                if (nb) {
+                    cb += ~q & COMPRESS_MASK;
+                    q = cb & COMPRESS_MASK;
+                    cb >>= COMPRESS_BIT;
+                }
+                r[i] = Op::op((base_t)p, (base_t)q);
+                if (neg) {
+                    c += ~r[i] & COMPRESS_MASK;
+                    r[i] = (base_t)(c & COMPRESS_MASK);
+                    c >>= COMPRESS_BIT;
+                }
+            }
+            sign = neg ? -1 : 1;
+        }
+        if (!na && !nb) sign = 1;
+        v.swap(r);
+        trim();
+        if (is_zero()) sign = 1;
+        return *this;
+    }
+    // whether the low n bits are all 0
+    bool raw_low_zero(uint64_t n) const {
+        size_t w = (size_t)std::min(n / COMPRESS_BIT, (uint64_t)size()), b = (size_t)(n % COMPRESS_BIT);
+        for (size_t i = 0; i < w; ++i)
+            if (v[i]) return false;
+        return w == size() || (v[w] & (((base_t)1 << b) - 1)) == 0;
+    }
+    // Newton iteration on the reciprocal x = COMPRESS_MOD^(2p) / bp, bp is the top p limbs of b
+    // (padded with zeros when the quotient is longer than b)
+    // each step gets the middle part of bp * x by a wrap-around product and then
+    // corrects x by a short product, which only keeps the high part
     BigInt_t &raw_fastdiv(const BigInt_t &a, const BigInt_t &b) {
         if (a.raw_less(b)) {
             set(0);
             return *this;
         }
-        if (b.size() * 2 - 2 > a.size()) {
-            BigInt_t ta = a, tb = b;
-            size_t ans_len = a.size() - b.size() + 2;
-            size_t r = b.size() - ans_len;
-            ta.raw_shr(r);
-            tb.raw_shr(r);
-            return raw_fastdiv(ta, tb);
-        }
         if (b.size() < BIGINT_DIV_THRESHOLD) {
             BigInt_t r;
             return raw_div(a, b, r);
         }
-        size_t extand_digs = 2;
-        size_t ans_len = a.size() - b.size() + extand_digs + 1, s_len = ans_len + 32;
+        size_t n = b.size(), p = a.size() - n + 4;
         std::vector<size_t> len_seq;
-        BigInt_t b2, x0, x1, t;
-        x1.v.resize(1);
-        x1.v.back() = (base_t)(COMPRESS_MOD / (b.v.back() + (double)(b.v[b.size() - 2]) / COMPRESS_MOD));
-        x0.v.push_back(x1.v.back() + 1);
-        size_t keep_size = 1;
-        while (s_len > 32) {
-            len_seq.push_back(std::min(s_len, ans_len));
-            s_len = s_len / 2 + 1;
-        }
-        while (x1 != x0) {
-            // x1 = x0(2 - x0 * b)
-            x0 = x1;
-            b2 = b;
-            size_t tsize = std::min(keep_size * 2, ans_len);
-            b2.keep(tsize);
-            t = x0 * b2;
-            t.keep(tsize);
-            for (size_t i = t.size() - 2; i < t.size(); --i)
-                t.v[i] ^= COMPRESS_MASK;
-            if (t.v.back() != 1) {
-                t.v.back() ^= COMPRESS_MASK;
-                t.v.push_back(1);
-            } else {
-                t.v.pop_back();
-                t.trim();
+        for (; p > BIGINT_MUL_THRESHOLD; p = p / 2 + 2)
+            len_seq.push_back(p);
+        BigInt_t x, e, t;
+        t.v.assign(p * 2 + 1, 0);
+        t.v.back() = 1;
+        x.raw_dividediv(t, b.raw_top_to(p), e);
+        for (size_t h = p; !len_seq.empty(); len_seq.pop_back(), h = p) {
+            p = len_seq.back();
+            // e = bp * x - COMPRESS_MOD^(p + h), |e| < COMPRESS_MOD^(p + 2)
+            size_t wrap = 1;
+            while (wrap < p + 3)
+                wrap *= 2;
+            e.raw_nttmul_wrap(b.raw_top_to(p), x, wrap);
+            e.v.resize(wrap);
+            size_t i = (p + h) % wrap;
+            for (; e.v[i] == 0; i = (i + 1) % wrap)
+                e.v[i] = COMPRESS_MASK;
+            --e.v[i];
+            bool neg = e.v.back() >> (COMPRESS_BIT - 1);
+            if (neg) {
+                for (size_t i = 0; i < e.size(); ++i)
+                    e.v[i] ^= COMPRESS_MASK;
+            }
+            e.trim();
+            // x = x - x * e / COMPRESS_MOD^(2h)
+            t.raw_mul_high(x, e, h * 2);
+            x.raw_shl(p - h);
+            neg ? x.raw_add(t) : x.raw_sub(t);
+        }
+        // keep one more limb to round the quotient
+        raw_mul_high(a, x, n + p - 1);
+        base_t f = v[0];
+        raw_shr(1);
+        sign = 1;
+        if (f <= 3 || f >= COMPRESS_MASK - 3) {
+            // too close to an integer, fix it with the remainder
+            BigInt_t ta = a, tb = b;
+            ta.sign = tb.sign = 1;
+            BigInt_t r = ta - *this * tb;
+            for (; r.sign < 0 && !r.is_zero(); r += tb)
+                raw_sub(BigInt_t(1));
+            for (; !r.raw_less(tb); r.raw_sub(tb))
+                raw_add(BigInt_t(1));
+        }
+        return *this;
+    }
+    // an upper bound of the bit length
+    size_t raw_bits() const { return (size() - 1) * COMPRESS_BIT + NTT_NS::log2(v.back()) + 1; }
+    static uint32_t raw_popcount(base_t x) {
+        x = x - ((x >> 1) & 0x55555555);
+        x = (x & 0x33333333) + ((x >> 2) & 0x33333333);
+        return (((x + (x >> 4)) & 0x0F0F0F0F) * 0x01010101) >> 24;
+    }
+    // *this = floor(a^(1/k)) for a > 0, Newton iteration from above
+    // the start point comes from the root of the top limbs, so only a few steps are needed
+    BigInt_t &raw_root(const BigInt_t &a, uint32_t k) {
+        size_t t = (a.size() - 1) / ((size_t)k * 2);
+        if (t == 0) {
+            std::vector<uint32_t> w(1, (uint32_t)((a.raw_bits() + k - 1) / k));
+            *this = POW_NS::pow_window(POW_NS::mul_ctx<BigInt_t>(), BigInt_t(2), w);
+        } else {
+            raw_root(a.raw_shr_to(t * k), k);
+            raw_add(BigInt_t(1));
+            raw_shl(t);
+        }
+        std::vector<uint32_t> w(1, k - 1);
+        BigInt_t km1((intmax_t)k - 1), kb((intmax_t)k), y;
+        for (;;) {
+            y = *this * km1;
+            y.raw_add(a / POW_NS::pow_window(POW_NS::mul_ctx<BigInt_t>(), *this, w));
+            y = y / kb;
+            if (!y.raw_less(*this)) break;
+            v.swap(y.v);
+        }
+        return *this;
+    }
+    // Karatsuba square root, a has n * 2 limbs and the top limb is at least COMPRESS_MOD / 4
+    // *this = floor(sqrt(a)), r = a - *this * *this
+    BigInt_t &raw_sqrt_rem_norm(const BigInt_t &a, size_t n, BigInt_t &r) {
+        if (n <= 2) {
+            raw_root(a, 2);
+            r = a - *this * *this;
+            return *this;
+        }
+        // the high root limbs from the top half, then the low l limbs by one division
+        size_t l = n / 2;
+        raw_sqrt_rem_norm(a.raw_shr_to(l * 2), n - l, r);
+        BigInt_t d = *this + *this, q, u;
+        r.raw_shl(l);
+        r += a.raw_shr_to(l).raw_lowdigits_to(l);
+        q = r / d;
+        u = r - q * d;
+        raw_shl(l);
+        *this += q;
+        u.raw_shl(l);
+        u += a.raw_lowdigits_to(l);
+        r = u - q * q;
+        if (r.sign < 0 && !r.is_zero()) {
+            r += *this;
+            raw_sub(BigInt_t(1));
+            r += *this;
+        }
+        return *this;
+    }
+    // *this = floor(sqrt(a)), r = a - *this * *this for a > 0
+    // a is shifted by 2k bits to an even number of limbs with a large top limb, then the root S and the
+    // remainder R of b = a * 4^k are scaled back. with S = s * 2^k + s0, r = (R + s0 * (2S - s0)) / 4^k
+    BigInt_t &raw_sqrt_rem(const BigInt_t &a, BigInt_t &r) {
+        if (a.size() <= 4) {
+            raw_root(a, 2);
+            r = a - *this * *this;
+            return *this;
+        }
+        size_t k = 0, bits = a.raw_bits();
+        while ((bits + k * 2) % (COMPRESS_BIT * 2) != 0 && (bits + k * 2) % (COMPRESS_BIT * 2) != COMPRESS_BIT * 2 - 1)
+            ++k;
+        BigInt_t b;
+        a.raw_mul_2exp_to(b, k * 2);
+        raw_sqrt_rem_norm(b, b.size() / 2, r);
+        if (k) {
+            base_t s0 = v[0] & (((base_t)1 << k) - 1);
+            BigInt_t t = *this + *this;
+            t -= s0;
+            r += t * s0;
+            r.raw_div_2exp(k * 2);
+            raw_div_2exp(k);
+        }
+        return *this;
+    }
+    // limb range kernels used by the divide and conquer division
+    static bool raw_less_n(const base_t *a, const base_t *b, size_t n) {
+        for (size_t i = n - 1; i < n; i--)
+            if (a[i] != b[i]) return a[i] < b[i];
+        return false; // eq
+    }
+    static base_t raw_add_n(base_t *r, const base_t *b, size_t n) {
+        ucarry_t add = 0;
+        for (size_t i = 0; i < n; i++)
+            carry(add, r[i], (ucarry_t)r[i] + b[i]);
+        return (base_t)add;
+    }
+    static base_t raw_sub_n(base_t *r, const base_t *b, size_t n) {
+        carry_t add = 0;
+        for (size_t i = 0; i < n; i++)
+            borrow(add, r[i], (carry_t)r[i] - (carry_t)b[i]);
+        return (base_t)-add;
+    }
+    static base_t raw_dec_n(base_t *r, size_t n) {
+        for (size_t i = 0; i < n; i++) {
+            if (r[i]) {
+                --r[i];
+                return 0;
+            }
+            r[i] = (base_t)(COMPRESS_MOD - 1);
+        }
+        return 1;
+    }
+    // r[0, an + bn) = a * b, ws[0..2] are scratch numbers which keep their capacity
+    static void raw_mul_n(base_t *r, const base_t *a, size_t an, const base_t *b, size_t bn, BigInt_t *ws) {
+        if (std::min(an, bn) <= BIGINT_MUL_THRESHOLD) {
+            std::fill(r, r + an + bn, 0);
+            for (size_t i = 0; i < an; i++) {
+                ucarry_t add = 0, av = a[i];
+                for (size_t j = 0; j < bn; ++j)
+                    carry(add, r[i + j], r[i + j] + av * b[j]);
+                r[i + bn] = (base_t)add;
             }
-            x1 *= t;
-            keep_size = std::min(keep_size * 2, s_len);
-            x1.keep(keep_size);
-        }
-        for (; !len_seq.empty(); len_seq.pop_back()) {
-            // x1 = x0(2 - x0 * b)
-            x0 = x1;
-            b2 = b;
-            size_t tsize = std::min(keep_size * 2, ans_len);
-            b2.keep(tsize);
-            t = x0 * b2;
-            t.keep(tsize);
-            for (size_t i = t.size() - 2; i < t.size(); --i)
-                t.v[i] ^= COMPRESS_MASK;
-            if (t.v.back() != 1) {
-                t.v.back() ^= COMPRESS_MASK;
-                t.v.push_back(1);
+            return;
+        }
+        ws[0].v.assign(a, a + an);
+        ws[0].trim();
+        ws[1].v.assign(b, b + bn);
+        ws[1].trim();
+        ws[2].raw_nttmul(ws[0], ws[1]);
+        std::copy(ws[2].v.begin(), ws[2].v.end(), r);
+        std::fill(r + ws[2].size(), r + an + bn, 0);
+    }
+    // schoolbook division of a[0, an) by the normalized b[0, bn), the quotient is
+    // written to q[0, an - bn) and the returned high limb, the remainder is left in a[0, bn)
+    static base_t raw_div_basecase(base_t *q, base_t *a, size_t an, const base_t *b, size_t bn) {
+        base_t qh = !raw_less_n(a + an - bn, b, bn);
+        if (qh) raw_sub_n(a + an - bn, b, bn);
+        ucarry_t b1 = b[bn - 1], b0 = b[bn - 2];
+        for (size_t i = an - bn - 1; i < an; i--) {
+            base_t *p = a + i;
+            ucarry_t rm = ((ucarry_t)p[bn] << COMPRESS_BIT) + p[bn - 1], m, rem;
+            if (p[bn] >= b1) {
+                m = COMPRESS_MOD - 1;
+                rem = rm - m * b1;
             } else {
-                t.v.pop_back();
-                t.trim();
+                m = rm / b1;
+                rem = rm - m * b1;
             }
-            ucarry_t add = 1;
-            for (size_t i = 0; add && i < t.v.size(); i++)
-                carry(add, t.v[i], (ucarry_t)t.v[i]);
-            if (add) t.v.push_back((base_t)add);
-            x1 *= t;
-            keep_size = len_seq.back();
-            x1.keep(keep_size);
-        }
-        x1 *= a;
-        if (x1.v[a.size() + extand_digs - 1] >= COMPRESS_MOD - 1)
-            *this = x1.raw_shr(a.size() + extand_digs).raw_add(BigInt_t(1));
-        else
-            *this = x1.raw_shr(a.size() + extand_digs);
-        return *this;
+            while (rem < COMPRESS_MOD && m * b0 > (rem << COMPRESS_BIT) + p[bn - 2]) {
+                --m;
+                rem += b1;
+            }
+            ucarry_t mul = 0;
+            carry_t add = 0;
+            for (size_t j = 0; j < bn; j++) {
+                mul += m * b[j];
+                borrow(add, p[j], (carry_t)p[j] - (carry_t)low_digit(mul));
+                mul = high_digit(mul);
+            }
+            borrow(add, p[bn], (carry_t)p[bn] - (carry_t)mul);
+            if (add) {
+                --m;
+                raw_add_n(p, b, bn);
+            }
+            p[bn] = 0;
+            q[i] = (base_t)m;
+        }
+        return qh;
+    }
+    // Burnikel-Ziegler 2n/1n division, a[0, 2n) / b[0, n), the quotient is written to
+    // q[0, n) and the returned high limb, the remainder is left in a[0, n)
+    // tp is a workspace of n limbs shared by all the recursion levels
+    static base_t raw_div_2n1n(base_t *q, base_t *a, const base_t *b, size_t n, base_t *tp, BigInt_t *ws) {
+        if (n <= BIGINT_DIVIDEDIV_THRESHOLD) return raw_div_basecase(q, a, n * 2, b, n);
+        size_t lo = n / 2, hi = n - lo;
+        // 3n/2n step on the high half
+        base_t qh = raw_div_2n1n(q + lo, a + lo * 2, b + lo, hi, tp, ws);
+        raw_mul_n(tp, q + lo, hi, b, lo, ws);
+        base_t cy = raw_sub_n(a + lo, tp, n);
+        if (qh) cy += raw_sub_n(a + n, b, lo);
+        while (cy) {
+            qh -= raw_dec_n(q + lo, hi);
+            cy -= raw_add_n(a + lo, b, n);
+        }
+        // 3n/2n step on the low half
+        base_t ql = raw_div_2n1n(q, a + hi, b + hi, lo, tp, ws);
+        raw_mul_n(tp, b, hi, q, lo, ws);
+        cy = raw_sub_n(a, tp, n);
+        if (ql) cy += raw_sub_n(a + lo, b, hi);
+        while (cy) {
+            raw_dec_n(q, lo);
+            cy -= raw_add_n(a, b, n);
+        }
+        return qh;
     }
+    // b must be normalized, the quotient is computed block by block with 2n/1n divisions
     BigInt_t &raw_dividediv_recursion(const BigInt_t &a, const BigInt_t &b, BigInt_t &r) {
-        if (a < b) {
+        if (a.raw_less(b)) {
             r = a;
             return set(0);
         } else if (b.size() <= BIGINT_DIVIDEDIV_THRESHOLD) {
             return raw_div(a, b, r);
         }
-        size_t base = (b.size() + 1) / 2;
-        if (a.size() <= base * 3) {
-            base = b.size() / 2;
-            BigInt_t ma = a, mb = b, e;
-            BigInt_t ha = ma.raw_shr_to(base);
-            BigInt_t hb = mb.raw_shr_to(base);
-            raw_dividediv_recursion(ha, hb, r);
-            ha = *this * b;
-            while (a < ha) {
-                ha.raw_sub(b);
-                raw_sub(BigInt_t(1));
-            }
-            r = a - ha;
-            return *this;
+        size_t n = b.size(), blocks = (a.size() - 1) / n;
+        std::vector<base_t> tp(n);
+        BigInt_t ws[3];
+        r.v.resize((blocks + 1) * n);
+        std::copy(a.v.begin(), a.v.end(), r.v.begin());
+        std::fill(r.v.begin() + a.size(), r.v.end(), 0);
+        v.assign(blocks * n + 1, 0);
+        sign = r.sign = 1;
+        base_t *rp = &r.v.front(), *qp = &v.front();
+        if (!raw_less_n(rp + blocks * n, &b.v.front(), n)) {
+            raw_sub_n(rp + blocks * n, &b.v.front(), n);
+            qp[blocks * n] = 1;
         }
-        if (a.size() > base * 4) base = a.size() / 2;
-        BigInt_t ha = a.raw_shr_to(base);
-        BigInt_t c, d, m;
-        raw_dividediv_recursion(ha, b, d);
-        raw_shl(base);
-        m.v.resize(base + d.size());
-        for (size_t i = 0; i < base; ++i)
-            m.v[i] = a.v[i];
-        for (size_t i = 0; i < d.size(); ++i)
-            m.v[base + i] = d.v[i];
-        c.raw_dividediv_recursion(m, b, r);
-        raw_add(c);
+        for (size_t i = blocks - 1; i < blocks; i--)
+            raw_div_2n1n(qp + i * n, rp + i * n, &b.v.front(), n, &tp.front(), ws);
+        r.v.resize(n);
+        r.trim();
+        trim();
         return *this;
     }
     BigInt_t &raw_dividediv(const BigInt_t &a, const BigInt_t &b, BigInt_t &r) {
-        if (b.size() <= BIGINT_DIVIDEDIV_THRESHOLD) {
+        if (b.size() <= BIGINT_DIVIDEDIV_THRESHOLD || a.raw_less(b)) {
             raw_div(a, b, r);
             return *this;
         }
@@ -563,11 +1140,25 @@ protected:
             size_t shr = b.size() - ans_len;
             ta.raw_shr(shr);
             tb.raw_shr(shr);
-            return raw_dividediv(ta, tb, r);
+            raw_dividediv(ta, tb, r);
+            // the quotient of the top limbs can be off by a few, fix it with the whole numbers
+            BigInt_t t;
+            t.raw_nttmul(*this, b);
+            r = a;
+            sign = r.sign = t.sign = 1;
+            for (; r.raw_less(t); raw_sub(BigInt_t(1)))
+                t.raw_sub(b);
+            r.raw_sub(t);
+            for (; !r.raw_less(b); raw_add(BigInt_t(1)))
+                r.raw_sub(b);
+            return *this;
         }
-        carry_t mul = (carry_t)(((uint64_t)(COMPRESS_MOD + 1) * (COMPRESS_MOD - 1)) /       //
-                                (*(b.v.begin() + b.v.size() - 1) * (uint64_t)COMPRESS_MOD + //
-                                 *(b.v.begin() + b.v.size() - 2) + 1));
+        // the top limb of a normalized divisor is already large enough
+        carry_t mul = 1;
+        if (b.v.back() < COMPRESS_MOD >> 1)
+            mul = (carry_t)(((uint64_t)(COMPRESS_MOD + 1) * (COMPRESS_MOD - 1)) /       //
+                            (*(b.v.begin() + b.v.size() - 1) * (uint64_t)COMPRESS_MOD + //
+                             *(b.v.begin() + b.v.size() - 2) + 1));
         BigInt_t ma = a * BigInt_t((intmax_t)mul), mb = b * BigInt_t((intmax_t)mul);
         while (mb.v.back() < COMPRESS_MOD >> 1) {
             int32_t m = 2;
@@ -586,25 +1177,145 @@ protected:
             v.pop_back();
     }
     size_t size() const { return v.size(); }
+    // kernels for a machine integer operand, given as sign and magnitude
+    static size_t raw_split(base_t d[], uint64_t m) {
+        size_t k = 0;
+        do {
+            d[k++] = (base_t)(m % COMPRESS_MOD);
+            m /= COMPRESS_MOD;
+        } while (m);
+        return k;
+    }
+    int raw_cmp_small(uint64_t m) const {
+        base_t d[8];
+        size_t k = raw_split(d, m);
+        if (size() != k) return size() < k ? -1 : 1;
+        for (size_t i = k; i-- > 0;)
+            if (v[i] != d[i]) return v[i] < d[i] ? -1 : 1;
+        return 0;
+    }
+    int raw_cmp_small(bool neg, uint64_t m) const {
+        bool n = sign < 0 && !is_zero();
+        neg = neg && m;
+        if (n != neg) return n ? -1 : 1;
+        int c = raw_cmp_small(m);
+        return n ? -c : c;
+    }
+    BigInt_t &raw_set_small(bool neg, uint64_t m) {
+        base_t d[8] = {0};
+        size_t k = raw_split(d, m);
+        v.assign(d, d + k);
+        sign = neg && m ? -1 : 1;
+        return *this;
+    }
+    BigInt_t &raw_add_small(bool neg, uint64_t m) {
+        if (m == 0) return *this;
+        if (is_zero()) return raw_set_small(neg, m);
+        v.unshare();
+        if ((sign < 0) == neg) {
+            for (size_t i = 0; m; ++i) {
+                if (i == size()) v.push_back(0);
+                uint64_t t = m % COMPRESS_MOD + v[i];
+                v[i] = (base_t)(t % COMPRESS_MOD);
+                m = m / COMPRESS_MOD + t / COMPRESS_MOD;
+            }
+            return *this;
+        }
+        if (raw_cmp_small(m) < 0) {
+            // |*this| < m fits in the machine integer
+            uint64_t s = 0;
+            for (size_t i = size(); i-- > 0;)
+                s = s * COMPRESS_MOD + v[i];
+            return raw_set_small(neg, m - s);
+        }
+        for (size_t i = 0; m; ++i) {
+            uint64_t t = m % COMPRESS_MOD;
+            m /= COMPRESS_MOD;
+            if (v[i] >= t) {
+                v[i] -= (base_t)t;
+            } else {
+                v[i] = (base_t)(v[i] + COMPRESS_MOD - t);
+                ++m;
+            }
+        }
+        trim();
+        if (is_zero()) sign = 1;
+        return *this;
+    }
+    BigInt_t &raw_mul_small(bool neg, uint64_t m) {
+        if (m < (uint64_t)COMPRESS_MOD) {
+            raw_mul_int((base_t)m);
+        } else {
+            // multiply in place from the top limb down
+            base_t d[8];
+            size_t k = raw_split(d, m), n = size();
+            v.resize(n + k, 0);
+            for (size_t i = n; i-- > 0;) {
+                uint64_t x = v[i], c = 0;
+                v[i] = 0;
+                for (size_t j = 0; j < k; ++j) {
+                    c += x * d[j] + v[i + j];
+                    v[i + j] = (base_t)(c % COMPRESS_MOD);
+                    c /= COMPRESS_MOD;
+                }
+                for (size_t j = i + k; c; ++j) {
+                    c += v[j];
+                    v[j] = (base_t)(c % COMPRESS_MOD);
+                    c /= COMPRESS_MOD;
+                }
+            }
+            trim();
+        }
+        if (neg) sign = -sign;
+        if (is_zero()) sign = 1;
+        return *this;
+    }
+    BigInt_t &raw_div_small(bool neg, uint64_t m) {
+        if (m > ~(uint64_t)0 / COMPRESS_MOD) {
+            BigInt_t b;
+            return *this /= b.raw_set_small(neg, m);
+        }
+        v.unshare();
+        uint64_t r = 0;
+        for (size_t i = size(); i-- > 0;) {
+            r = r * COMPRESS_MOD + v[i];
+            v[i] = (base_t)(r / m);
+            r %= m;
+        }
+        trim();
+        if (neg) sign = -sign;
+        if (is_zero()) sign = 1;
+        return *this;
+    }
+    BigInt_t &raw_mod_small(uint64_t m) {
+        if (m > ~(uint64_t)0 / COMPRESS_MOD) {
+            BigInt_t b;
+            return *this %= b.raw_set_small(false, m);
+        }
+        uint64_t r = 0;
+        for (size_t i = size(); i-- > 0;)
+            r = (r * COMPRESS_MOD + v[i]) % m;
+        return raw_set_small(sign < 0, r);
+    }
     //{hexm_e}
-    BigIntBase transbase(int32_t out_base) const {
-        if (size() <= 8) {
+    static BigIntBase raw_transbase(const view_t &a, int32_t out_base) {
+        if (a.size() <= 8) {
             BigIntBase sum(out_base);
             BigIntBase base(out_base);
             BigIntBase ownbase(out_base);
             ownbase.set(COMPRESS_MOD);
             BigIntBase mul(out_base), t(out_base);
             base.set(1);
-            t.set(v[0]);
+            t.set(a.v[0]);
             mul.raw_mul(base, t);
             sum.raw_add(mul);
-            for (size_t i = 1; i < v.size(); i++) {
+            for (size_t i = 1; i < a.size(); i++) {
                 base.raw_mul(ownbase, BigIntBase(base));
-                t.set(v[i]);
+                t.set(a.v[i]);
                 mul.raw_mul(base, t);
                 sum.raw_add(mul);
             }
-            return BIGINT_STD_MOVE(sum);
+            return sum;
         } else {
             static std::vector<BigIntBase> pow_list;
             static int32_t last_base = 0, pow_list_cnt;
@@ -616,7 +1327,7 @@ protected:
                 last_base = out_base;
             }
             size_t s = 1, id = 0;
-            for (; s < size() / 3; s *= 2, ++id) {
+            for (; s < a.size() / 3; s *= 2, ++id) {
                 if (s >= (size_t)1 << pow_list_cnt) {
                     pow_list.push_back(BigIntBase(out_base));
                     pow_list.back().raw_nttsqr(pow_list[pow_list_cnt]);
@@ -624,18 +1335,16 @@ protected:
                 }
             }
             base = pow_list[id];
-            BigInt_t h = raw_shr_to(s), l = *this;
-            l.v.resize(s);
-            BigIntBase r = h.transbase(out_base);
+            BigIntBase r = raw_transbase(a.shr(s), out_base);
             BigIntBase sum(out_base);
             sum.raw_nttmul(r, base);
-            r = l.transbase(out_base);
+            r = raw_transbase(a.low(s), out_base);
             sum.raw_add(r);
-            return BIGINT_STD_MOVE(sum);
+            return sum;
         }
     }
     std::string out_mul(int32_t out_base = 10, int32_t pack = 0) const {
-        BigIntBase sum = transbase(out_base);
+        BigIntBase sum = raw_transbase(*this, out_base);
         std::string out;
         int32_t d = 0;
         for (size_t i = 0, j = 0;;) {
@@ -727,10 +1436,10 @@ protected:
         return *this;
     }
     //{hexm_e}
-    BigInt_t &_from_str(const std::string &s, int base) {
-        if (s.size() <= 12) {
+    BigInt_t &_from_str(const char *s, size_t n, int base) {
+        if (n <= 12) {
             int64_t v = 0;
-            for (size_t i = 0; i < s.size(); ++i) {
+            for (size_t i = 0; i < n; ++i) {
                 int digit = -1;
                 if (s[i] >= '0' && s[i] <= '9')
                     digit = s[i] - '0';
@@ -744,17 +1453,19 @@ protected:
         }
         BigInt_t m(base), h;
         size_t len = 1;
-        for (; len * 3 < s.size(); len *= 2) {
+        for (; len * 3 < n; len *= 2) {
             m *= m;
         }
-        h._from_str(s.substr(0, s.size() - len), base);
-        _from_str(s.substr(s.size() - len), base);
+        h._from_str(s, n - len, base);
+        _from_str(s + n - len, len, base);
         *this += m * h;
         return *this;
     }
     //{hexm_b}
 public:
     BigIntHex() { set(0); }
+    // zero, the limbs of this number are taken from the arena, which must outlive it
+    explicit BigIntHex(BigIntArena &arena) : v(arena) { set(0); }
     explicit BigIntHex(int n) { set(n); }
     explicit BigIntHex(intmax_t n) { set(n); }
     explicit BigIntHex(const char *s, int base = 10) { from_str(s, base); }
@@ -799,7 +1510,7 @@ public:
             ++i;
             vsign = -vsign;
         }
-        _from_str(std::string(s + i), base);
+        _from_str(s + i, strlen(s + i), base);
         sign = vsign;
         return *this;
         //{hexm_b}
@@ -828,15 +1539,16 @@ public:
         return raw_eq(b);
     }
     LESS_THAN_AND_EQUAL_COMPARABLE(BigInt_t)
+    BIGINT_ALL_INT_OPERATORS(BigInt_t)
 
     BigInt_t &operator=(intmax_t n) { return set(n); }
     BigInt_t &operator=(const char *s) { return from_str(s); }
     BigInt_t &operator=(const std::string s) { return from_str(s); }
-    BigInt_t operator+(const BigInt_t &b) const {
+    BigInt_t operator+(const BigInt_t &b) BIGINT_CONST_REF {
         if (sign * b.sign > 0)
             return BIGINT_STD_MOVE(BigInt_t(*this).raw_add(b));
         else if (size() < b.size())
-            return BIGINT_STD_MOVE(BigInt_t(b).raw_sub(*this).inv());
+            return BIGINT_STD_MOVE(BigInt_t(b).raw_sub(*this));
         else
             return BIGINT_STD_MOVE(BigInt_t(*this).raw_sub(b));
     }
@@ -846,13 +1558,13 @@ public:
         if (sign * b.sign > 0)
             raw_add(b);
         else if (size() < b.size())
-            *this = BIGINT_STD_MOVE(BigInt_t(b).raw_sub(*this).inv());
+            *this = BIGINT_STD_MOVE(BigInt_t(b).raw_sub(*this));
         else
             raw_sub(b);
         return *this;
     }
 
-    BigInt_t operator-(const BigInt_t &b) const {
+    BigInt_t operator-(const BigInt_t &b) BIGINT_CONST_REF {
         if (sign * b.sign < 0)
             return BIGINT_STD_MOVE(BigInt_t(*this).raw_add(b));
         else if (size() < b.size())
@@ -881,17 +1593,17 @@ public:
         return BIGINT_STD_MOVE(BigInt_t(*this).inv());
     }
 
-    BigInt_t operator*(const BigInt_t &b) const {
+    BigInt_t operator*(const BigInt_t &b) BIGINT_CONST_REF {
         if (b.size() == 1) {
             BigInt_t r = *this;
             r.raw_mul_int((uint32_t)b.v[0]);
             r.sign *= b.sign;
-            return BIGINT_STD_MOVE(r);
+            return r;
         } else if (v.size() == 1) {
             BigInt_t r = b;
             r.raw_mul_int((uint32_t)v[0]);
             r.sign *= sign;
-            return BIGINT_STD_MOVE(r);
+            return r;
         } else {
             BigInt_t r;
             if (raw_less(b))
@@ -899,7 +1611,7 @@ public:
             else
                 r.raw_nttmul(b, *this);
             r.sign = sign * b.sign;
-            return BIGINT_STD_MOVE(r);
+            return r;
         }
     }
     BigInt_t &operator*=(const BigInt_t &b) {
@@ -908,25 +1620,46 @@ public:
             sign *= b.sign;
             return *this;
         } else {
-            return *this = *this * b;
+            BigInt_t r = *this * b;
+            v.swap(r.v);
+            sign = r.sign;
+            return *this;
         }
     }
 
-    BigInt_t operator/(const BigInt_t &b) const {
+    BigInt_t operator/(const BigInt_t &b) BIGINT_CONST_REF {
         BigInt_t r, d;
         if (b.size() > BIGINT_DIV_THRESHOLD)
             d.raw_fastdiv(*this, b);
         else
             d.raw_dividediv(*this, b, r);
         d.sign = sign * b.sign;
-        return BIGINT_STD_MOVE(d);
+        return d;
     }
     BigInt_t &operator/=(const BigInt_t &b) {
         if (this == &b) {
             return set(1);
         }
-        return *this = *this / b;
+        BigInt_t d = *this / b;
+        v.swap(d.v);
+        sign = d.sign;
+        return *this;
     }
+#if BIGINT_RVALUE_REF
+    // a temporary left operand keeps its buffer for the result
+    BigInt_t operator+(const BigInt_t &b) && { return BIGINT_STD_MOVE(*this += b); }
+    BigInt_t operator+(BigInt_t &&b) const & { return BIGINT_STD_MOVE(b += *this); }
+    BigInt_t operator+(BigInt_t &&b) && { return BIGINT_STD_MOVE(size() < b.size() ? b += *this : *this += b); }
+    BigInt_t operator-(const BigInt_t &b) && { return BIGINT_STD_MOVE(*this -= b); }
+    BigInt_t operator-(BigInt_t &&b) const & {
+        b -= *this;
+        if (!b.is_zero()) b.inv();
+        return BIGINT_STD_MOVE(b);
+    }
+    BigInt_t operator-(BigInt_t &&b) && { return BIGINT_STD_MOVE(*this -= b); }
+    BigInt_t operator*(const BigInt_t &b) && { return BIGINT_STD_MOVE(*this *= b); }
+    BigInt_t operator/(const BigInt_t &b) && { return BIGINT_STD_MOVE(*this /= b); }
+#endif
     BigInt_t operator%(const BigInt_t &b) const {
         if (b.size() == 1 && COMPRESS_MOD % b.v[0] == 0) {
             return BigInt_t((intmax_t)(v[0] % b.v[0]) * sign);
@@ -938,13 +1671,19 @@ public:
     }
     BigInt_t &operator%=(const BigInt_t &b) {
         if (b.size() == 1 && COMPRESS_MOD % b.v[0] == 0) {
-            return set(v[0] % b.v[0] * sign);
+            return set((intmax_t)(v[0] % b.v[0]) * sign);
         }
         if (this == &b) {
             return set(0);
         }
         return *this = *this % b;
     }
+    // *this += a * b, the product of short operands is added in place without a temporary
+    BigInt_t &addmul(const BigInt_t &a, const BigInt_t &b) { return raw_addmul(a, b, 1); }
+    BigInt_t &submul(const BigInt_t &a, const BigInt_t &b) { return raw_addmul(a, b, -1); }
+    template <class E> BigInt_t &operator=(const EXPR_NS::Expr<E> &e) { return EXPR_NS::assign(*this, e.self(), 0); }
+    template <class E> BigInt_t &operator+=(const EXPR_NS::Expr<E> &e) { return EXPR_NS::assign(*this, e.self(), 1); }
+    template <class E> BigInt_t &operator-=(const EXPR_NS::Expr<E> &e) { return EXPR_NS::assign(*this, e.self(), -1); }
     BigInt_t div(const BigInt_t &b, BigInt_t &r) {
         if (this == &b) {
             r.set(0);
@@ -956,9 +1695,122 @@ public:
         r = *this - d * b;
         // d.raw_dividediv(*this, b, r);
         // d.sign = sign * b.sign;
-        return BIGINT_STD_MOVE(d);
+        return d;
+    }
+
+    // *this * 2^n
+    BigInt_t operator<<(uint64_t n) const {
+        BigInt_t r;
+        raw_mul_2exp_to(r, n);
+        r.sign = r.is_zero() ? 1 : sign;
+        return r;
+    }
+    BigInt_t &operator<<=(uint64_t n) { return raw_mul_2exp(n); }
+    // *this / 2^n rounded toward negative infinity, as the shift of two's complement
+    BigInt_t operator>>(uint64_t n) const {
+        BigInt_t r;
+        raw_div_2exp_to(r, n);
+        if (sign < 0 && !raw_low_zero(n)) r.raw_add(BigInt_t(1));
+        r.sign = r.is_zero() ? 1 : sign;
+        return r;
+    }
+    BigInt_t &operator>>=(uint64_t n) {
+        int s = sign;
+        bool inexact = s < 0 && !raw_low_zero(n);
+        raw_div_2exp(n);
+        if (inexact) raw_add(BigInt_t(1));
+        sign = is_zero() ? 1 : s;
+        return *this;
+    }
+
+    // the bitwise operations act on the two's complement forms, as on the built-in integers
+    BigInt_t operator&(const BigInt_t &b) const {
+        BigInt_t r;
+        return BIGINT_STD_MOVE(r.raw_bitwise<BitAnd>(*this, b));
+    }
+    BigInt_t &operator&=(const BigInt_t &b) { return raw_bitwise<BitAnd>(*this, b); }
+    BigInt_t operator|(const BigInt_t &b) const {
+        BigInt_t r;
+        return BIGINT_STD_MOVE(r.raw_bitwise<BitOr>(*this, b));
+    }
+    BigInt_t &operator|=(const BigInt_t &b) { return raw_bitwise<BitOr>(*this, b); }
+    BigInt_t operator^(const BigInt_t &b) const {
+        BigInt_t r;
+        return BIGINT_STD_MOVE(r.raw_bitwise<BitXor>(*this, b));
+    }
+    BigInt_t &operator^=(const BigInt_t &b) { return raw_bitwise<BitXor>(*this, b); }
+    // ~a = -a - 1
+    BigInt_t operator~() const {
+        BigInt_t r = *this;
+        if (r.sign < 0 && !r.is_zero()) {
+            r.raw_sub(BigInt_t(1));
+            r.sign = 1;
+        } else {
+            r.raw_add(BigInt_t(1));
+            r.sign = -1;
+        }
+        return r;
+    }
+    // the number of bits of |a|, 0 for 0
+    size_t bit_length() const { return is_zero() ? 0 : raw_bits(); }
+    // the number of 1 bits of |a|
+    size_t popcount() const {
+        size_t n = 0;
+        for (size_t i = 0; i < size(); ++i)
+            n += raw_popcount(v[i]);
+        return n;
+    }
+    // the number of 0 bits below the lowest 1 bit, 0 for 0
+    size_t count_trailing_zeros() const {
+        if (is_zero()) return 0;
+        size_t i = 0;
+        while (v[i] == 0)
+            ++i;
+        size_t n = i * COMPRESS_BIT;
+        for (base_t x = v[i]; (x & 1) == 0; x >>= 1)
+            ++n;
+        return n;
+    }
+    // bit n of the two's complement form
+    bool test_bit(uint64_t n) const {
+        size_t w = (size_t)(n / COMPRESS_BIT);
+        bool bit = w < size() && (v[w] >> (n % COMPRESS_BIT) & 1);
+        if (sign > 0 || is_zero()) return bit;
+        // -a = ~(a - 1), the borrow of a - 1 reaches bit n if the bits below it are 0
+        return !(bit != raw_low_zero(n));
+    }
+    // sets bit n of the two's complement form, adding or subtracting 2^n
+    BigInt_t &set_bit(uint64_t n, bool value = true) {
+        if (test_bit(n) == value) return *this;
+        size_t w = (size_t)(n / COMPRESS_BIT);
+        if (sign > 0 || is_zero()) {
+            v.unshare();
+            if (w >= size()) v.resize(w + 1);
+            sign = 1;
+            v[w] ^= (base_t)1 << (n % COMPRESS_BIT);
+            trim();
+            return *this;
+        }
+        BigInt_t p;
+        BigInt_t(1).raw_mul_2exp_to(p, n);
+        return *this += value ? p : -p;
     }
 
+    // n!, the odd part by prime swing and then the power of 2
+    static BigInt_t factorial(uint32_t n) {
+        BigInt_t r = COMB_NS::odd_factorial<BigInt_t>(n, COMB_NS::primes(n));
+        return r.raw_mul_2exp(COMB_NS::factorial_twos(n));
+    }
+    // n! / (k! (n - k)!), 0 if k > n
+    static BigInt_t binomial(uint32_t n, uint32_t k) {
+        if (k > n) return BigInt_t(0);
+        uint64_t twos;
+        BigInt_t r = COMB_NS::odd_binomial<BigInt_t>(n, k, twos);
+        return r.raw_mul_2exp(twos);
+    }
+    // the product of the primes not greater than n
+    static BigInt_t primorial(uint32_t n) { return COMB_NS::primorial<BigInt_t>(n); }
+
     std::string to_str(int32_t out_base = 10, int32_t pack = 0) const {
         //{hexm_e}
         if ((out_base & (out_base - 1)) == 0) {
@@ -980,6 +1832,1230 @@ public:
         //{hexm_b}
     }
 };
+
+// Montgomery context for the products modulo a fixed odd m
+// a number x is kept as x * R mod m, where R = COMPRESS_MOD^n and n is the size of m
+class BigIntHexMont {
+protected:
+    typedef uint32_t base_t;
+    typedef uint64_t ucarry_t;
+    typedef BigIntHex BigInt_t;
+    typedef std::vector<NTT_NS::ntt_base_t> ntt_vector_t;
+    BigInt_t m, mp, r1, r2; // mp = -1 / m mod R, r1 = R mod m, r2 = R^2 mod m
+    base_t minv;            // -1 / m mod COMPRESS_MOD
+    size_t n, wrap_m, wrap_mp;
+    ntt_vector_t fm1, fm2, fmp1, fmp2; // cached transforms of m and mp
+
+    static void ntt_cache(const BigInt_t &b, size_t len, ntt_vector_t &fb1, ntt_vector_t &fb2) {
+        NTT_NS::NTTBuffers &nb = NTT_NS::ntt_buffers;
+        ntt_vector_t &ntt_b = nb.ntt1.ntt_b;
+        ntt_b.resize(b.size() * 2);
+        for (size_t i = 0, j = 0; i < b.size(); ++i, ++j) {
+            ntt_b[j] = b.v[i] & COMPRESS_HALF_MASK;
+            ntt_b[++j] = b.v[i] >> COMPRESS_HALF_BIT;
+        }
+        NTT_NS::ntt_prepare_cyclic(nb, len * 2, 5);
+        NTT_NS::ntt_cache(nb, fb1, fb2);
+    }
+    // r = a * b mod (COMPRESS_MOD^len - 1), fb1 and fb2 are the cached transforms of b
+    static void mul_cached(BigInt_t &r, const BigInt_t &a, size_t len, const ntt_vector_t &fb1, const ntt_vector_t &fb2) {
+        NTT_NS::NTTBuffers &nb = NTT_NS::ntt_buffers;
+        ntt_vector_t &ntt_a = nb.ntt1.ntt_a;
+        std::vector<int64_t> &ntt_c = nb.ntt1.ntt_c;
+        ntt_a.resize(a.size() * 2);
+        for (size_t i = 0, j = 0; i < a.size(); ++i, ++j) {
+            ntt_a[j] = a.v[i] & COMPRESS_HALF_MASK;
+            ntt_a[++j] = a.v[i] >> COMPRESS_HALF_BIT;
+        }
+        NTT_NS::ntt_prepare_cyclic(nb, len * 2, 2);
+        NTT_NS::mul_conv_cached(nb, fb1, fb2);
+        r.v.resize(len);
+        uint64_t add = 0;
+        for (size_t i = 0; i < len; ++i) {
+            add += ntt_c[i * 2] + ((ntt_c[i * 2 + 1] & COMPRESS_HALF_MASK) << COMPRESS_HALF_BIT);
+            r.v[i] = low_digit(add);
+            add = high_digit(add) + (ntt_c[i * 2 + 1] >> COMPRESS_HALF_BIT);
+        }
+        for (size_t i = 0; add; i = (i + 1) % len)
+            BigInt_t::carry(add, r.v[i], (uint64_t)r.v[i]);
+        r.sign = 1;
+    }
+    // t = t / R mod m, t should be less than m * R
+    void redc(BigInt_t &t) const {
+        if (n <= BIGINT_MUL_THRESHOLD) {
+            t.v.resize(n * 2 + 1);
+            for (size_t i = 0; i < n; ++i) {
+                ucarry_t add = 0, u = (base_t)(t.v[i] * minv) & COMPRESS_MASK;
+                for (size_t j = 0; j < n; ++j)
+                    BigInt_t::carry(add, t.v[i + j], t.v[i + j] + u * m.v[j]);
+                for (size_t j = i + n; add; ++j)
+                    BigInt_t::carry(add, t.v[j], (ucarry_t)t.v[j]);
+            }
+            t.raw_shr(n);
+            t.trim();
+        } else {
+            BigInt_t lo = t.raw_lowdigits_to(n), q, h;
+            t.raw_shr(n);
+            if (!lo.is_zero()) {
+                // lo + q * m = 0 mod R, so only the high part of q * m is needed
+                if (wrap_mp)
+                    mul_cached(q, lo, wrap_mp, fmp1, fmp2);
+                else
+                    q.raw_nttmul(lo, mp);
+                if (q.size() > n) q.v.resize(n);
+                q.trim();
+                if (wrap_m) {
+                    // q * m = h * R + (R - lo), the low part is known
+                    // so h * R is got from q * m mod (COMPRESS_MOD^wrap_m - 1)
+                    mul_cached(h, q, wrap_m, fm1, fm2);
+                    lo.raw_sub(BigInt_t(1));
+                    lo.v.resize(n);
+                    lo.v.resize(wrap_m, COMPRESS_MASK);
+                    ucarry_t add = 0;
+                    for (size_t i = 0; i < wrap_m; ++i)
+                        BigInt_t::carry(add, h.v[i], (ucarry_t)h.v[i] + lo.v[i]);
+                    for (size_t i = 0; add; i = (i + 1) % wrap_m)
+                        BigInt_t::carry(add, h.v[i], (ucarry_t)h.v[i]);
+                    std::rotate(h.v.begin(), h.v.begin() + n, h.v.end());
+                    h.trim();
+                    if (h.size() > n) h.set(0); // all limbs are COMPRESS_MASK, it is 0
+                } else {
+                    h.raw_nttmul(q, m);
+                    h.raw_shr(n);
+                }
+                t.raw_add(h);
+                t.raw_add(BigInt_t(1));
+            }
+        }
+        t.sign = 1;
+        if (!t.raw_less(m)) t.raw_sub(m);
+    }
+
+public:
+    // m should be odd
+    explicit BigIntHexMont(const BigInt_t &mod) : m(mod), n(mod.size()), wrap_m(0), wrap_mp(0) {
+        m.sign = 1;
+        base_t m0 = m.v[0], x = m0;
+        for (int i = 0; i < 4; ++i)
+            x *= 2 - m0 * x;
+        minv = (0 - x) & COMPRESS_MASK;
+        // newton iteration mp = mp * (2 + m * mp) mod COMPRESS_MOD^k
+        mp.set(minv);
+        for (size_t k = 1; k < n;) {
+            k = std::min(k * 2, n);
+            BigInt_t t = (m.raw_lowdigits_to(k) * mp).raw_lowdigits_to(k) + BigInt_t(2);
+            mp = (mp * t.raw_lowdigits_to(k)).raw_lowdigits_to(k);
+        }
+        r1.v.assign(n + 1, 0);
+        r1.v.back() = 1;
+        r1 %= m;
+        r2.v.assign(n * 2 + 1, 0);
+        r2.v.back() = 1;
+        r2 %= m;
+        if (n > BIGINT_NTT_THRESHOLD / 2) {
+            for (wrap_m = 1; wrap_m < n;)
+                wrap_m *= 2;
+            wrap_mp = wrap_m * 2;
+            if (wrap_mp * 2 > NTT_MAX_SIZE) {
+                wrap_m = wrap_mp = 0;
+            } else {
+                ntt_cache(m, wrap_m, fm1, fm2);
+                ntt_cache(mp, wrap_mp, fmp1, fmp2);
+            }
+        }
+    }
+    const BigInt_t &mod() const { return m; }
+    // 1 in Montgomery form
+    const BigInt_t &one() const { return r1; }
+    BigInt_t to_mont(const BigInt_t &a) const {
+        BigInt_t t = a;
+        if (t.sign < 0 || !t.raw_less(m)) {
+            t %= m;
+            if (t.sign < 0 && !t.is_zero()) t += m;
+            t.sign = 1;
+        }
+        return mul(t, r2);
+    }
+    BigInt_t from_mont(const BigInt_t &a) const {
+        BigInt_t t = a;
+        redc(t);
+        return t;
+    }
+    BigInt_t mul(const BigInt_t &a, const BigInt_t &b) const {
+        BigInt_t t;
+        t.raw_nttmul(a, b);
+        redc(t);
+        return t;
+    }
+    BigInt_t sqr(const BigInt_t &a) const {
+        BigInt_t t;
+        t.raw_nttmul(a, a);
+        redc(t);
+        return t;
+    }
+    // a^e, both a and the result are in Montgomery form
+    BigInt_t pow(const BigInt_t &a, const BigInt_t &e) const { return POW_NS::pow_window(*this, a, e.raw_words()); }
+};
+
+// Barrett reduction for the products modulo a fixed m, it works for any m
+class BigIntHexBarrett {
+protected:
+    typedef BigIntHex BigInt_t;
+    BigInt_t m, mu; // mu = COMPRESS_MOD^(2n) / m, n is the size of m
+    size_t n;
+
+public:
+    explicit BigIntHexBarrett(const BigInt_t &mod) : m(mod), n(mod.size()) {
+        m.sign = 1;
+        mu.v.assign(n * 2 + 1, 0);
+        mu.v.back() = 1;
+        mu /= m;
+    }
+    const BigInt_t &mod() const { return m; }
+    BigInt_t one() const { return reduce(BigInt_t(1)); }
+    // a mod m, in [0, m)
+    BigInt_t reduce(const BigInt_t &a) const {
+        BigInt_t r = a;
+        if (r.sign < 0 || r.size() > n * 2) {
+            r %= m;
+            if (r.sign < 0 && !r.is_zero()) r += m;
+            r.sign = 1;
+            return r;
+        }
+        if (r.size() >= n) {
+            // q is less than a / m by at most 3
+            BigInt_t q, t;
+            q.raw_mul_high(r.raw_shr_to(n - 1), mu, n + 1);
+            t.raw_nttmul(q, m);
+            r.raw_sub(t);
+        }
+        while (!r.raw_less(m))
+            r.raw_sub(m);
+        return r;
+    }
+    BigInt_t mul(const BigInt_t &a, const BigInt_t &b) const {
+        BigInt_t t;
+        t.raw_nttmul(a, b);
+        return reduce(t);
+    }
+    BigInt_t sqr(const BigInt_t &a) const {
+        BigInt_t t;
+        t.raw_nttmul(a, a);
+        return reduce(t);
+    }
+    // a^e mod m, a should be reduced
+    BigInt_t pow(const BigInt_t &a, const BigInt_t &e) const { return POW_NS::pow_window(*this, a, e.raw_words()); }
+};
+
+// precomputed powers of a fixed base g modulo a fixed m, by Montgomery for an odd m and by Barrett
+// for an even m like powmod. only one of mont and barrett holds a context
+class BigIntHexPowTable {
+protected:
+    typedef BigIntHex BigInt_t;
+    std::vector<BigIntHexMont> mont;
+    std::vector<BigIntHexBarrett> barrett;
+    std::vector<BigInt_t> table;
+    size_t k;
+
+public:
+    // the exponents less than 2^bits use the table
+    BigIntHexPowTable(const BigInt_t &g, const BigInt_t &m, size_t bits) : k(POW_NS::fixed_window(bits)) {
+        if ((m % BigInt_t(2)).is_zero()) {
+            barrett.push_back(BigIntHexBarrett(m));
+            POW_NS::pow_table(barrett[0], barrett[0].reduce(g), bits, k, table);
+        } else {
+            mont.push_back(BigIntHexMont(m));
+            POW_NS::pow_table(mont[0], mont[0].to_mont(g), bits, k, table);
+        }
+    }
+    // g^e mod m
+    BigInt_t pow(const BigInt_t &e) const {
+        if (mont.empty()) return POW_NS::pow_fixed(barrett[0], table, k, e.raw_words());
+        return mont[0].from_mont(POW_NS::pow_fixed(mont[0], table, k, e.raw_words()));
+    }
+};
+
+// Lehmer's algorithm on the top bits for small numbers, half-gcd for large numbers
+class BigIntHexGcd {
+public:
+    typedef BigIntHex BigInt_t;
+
+private:
+    typedef BigInt_t::base_t base_t;
+    // (a; b) = m * (a'; b'), det m = 1 and the entries are not negative
+    struct Matrix {
+        BigInt_t m[2][2];
+        Matrix() { m[0][0] = m[1][1] = BigInt_t(1); }
+        Matrix operator*(const Matrix &b) const {
+            Matrix r;
+            for (int i = 0; i < 2; ++i)
+                for (int j = 0; j < 2; ++j)
+                    r.m[i][j] = m[i][0] * b.m[0][j] + m[i][1] * b.m[1][j];
+            return r;
+        }
+    };
+
+    static int64_t iabs(int64_t x) { return x < 0 ? -x : x; }
+    // x >> sh, the result should be less than 2^64
+    static uint64_t top_bits(const BigInt_t &x, size_t sh) {
+        uint64_t r = 0;
+        size_t i = sh / COMPRESS_BIT, o = sh % COMPRESS_BIT;
+        for (size_t k = 0, p = 0; i + k < x.size() && p < 64 + o; ++k, p += COMPRESS_BIT)
+            r |= p >= o ? (uint64_t)x.v[i + k] << (p - o) : (uint64_t)x.v[i + k] >> (o - p);
+        return r;
+    }
+    // Lehmer's steps on the top 62 bits of a and b, (a'; b') = u * (a; b), det u = 1
+    // a step is taken only if the quotient is right for the whole numbers and
+    // both of them stay at least COMPRESS_MOD^s
+    static bool lehmer(const BigInt_t &a, const BigInt_t &b, size_t s, int64_t u[2][2]) {
+        const int64_t lim = (int64_t)1 << 31;
+        size_t bits = std::max(a.raw_bits(), b.raw_bits()), sh = bits > 62 ? bits - 62 : 0;
+        int64_t x[2] = {(int64_t)top_bits(a, sh), (int64_t)top_bits(b, sh)};
+        int64_t thr = s * COMPRESS_BIT > sh ? (int64_t)1 << (s * COMPRESS_BIT - sh) : 1;
+        bool stepped = false;
+        u[0][0] = u[1][1] = 1;
+        u[0][1] = u[1][0] = 0;
+        for (;;) {
+            // x[i] - q * x[j], the true values are in [lo, hi]
+            int i = x[0] < x[1], j = !i;
+            int64_t lo[2] = {x[0], x[1]}, hi[2] = {x[0], x[1]};
+            if (sh) {
+                for (int k = 0; k < 2; ++k) {
+                    lo[k] += std::min(u[k][0], (int64_t)0) + std::min(u[k][1], (int64_t)0);
+                    hi[k] += std::max(u[k][0], (int64_t)0) + std::max(u[k][1], (int64_t)0);
+                }
+            }
+            if (lo[j] <= 0 || lo[i] < 0) break;
+            int64_t q = lo[i] / hi[j];
+            if (q == 0 || q != hi[i] / lo[j] || q >= lim) break;
+            if (lo[i] - q * hi[j] < thr) break;
+            if (iabs(u[i][0]) + q * iabs(u[j][0]) >= lim || iabs(u[i][1]) + q * iabs(u[j][1]) >= lim) break;
+            x[i] -= q * x[j];
+            u[i][0] -= q * u[j][0];
+            u[i][1] -= q * u[j][1];
+            stepped = true;
+        }
+        return stepped;
+    }
+    // x * a + y * b, x and y have different signs and the result is not negative
+    static BigInt_t combine(const BigInt_t &a, int64_t x, const BigInt_t &b, int64_t y) {
+        BigInt_t r = a, t = b;
+        r.raw_mul_int((base_t)iabs(x));
+        t.raw_mul_int((base_t)iabs(y));
+        if (x < 0) std::swap(r, t);
+        r.raw_sub(t);
+        r.sign = 1;
+        return r;
+    }
+    static void apply(BigInt_t &a, BigInt_t &b, int64_t u[2][2]) {
+        BigInt_t t = combine(a, u[0][0], b, u[0][1]);
+        b = combine(a, u[1][0], b, u[1][1]);
+        a = t;
+    }
+    // the same for the signed cofactors
+    static void apply_cofactor(BigInt_t *c, int64_t u[2][2]) {
+        BigInt_t t = c[0] * BigInt_t((intmax_t)u[0][0]) + c[1] * BigInt_t((intmax_t)u[0][1]);
+        c[1] = c[0] * BigInt_t((intmax_t)u[1][0]) + c[1] * BigInt_t((intmax_t)u[1][1]);
+        c[0] = t;
+    }
+    // M = M * u^-1, u^-1 = (u11, -u01; -u10, u00) has no negative entries
+    static void mul_inverse(Matrix &M, int64_t u[2][2]) {
+        for (int i = 0; i < 2; ++i) {
+            BigInt_t a = M.m[i][0], b = M.m[i][1], t;
+            M.m[i][0].raw_mul_int((base_t)u[1][1]);
+            t = b;
+            M.m[i][0].raw_add(t.raw_mul_int((base_t)-u[1][0]));
+            M.m[i][1].raw_mul_int((base_t)u[0][0]);
+            t = a;
+            M.m[i][1].raw_add(t.raw_mul_int((base_t)-u[0][1]));
+        }
+    }
+    // one division step on the larger one, both of them stay at least COMPRESS_MOD^s
+    static bool subdiv(BigInt_t &a, BigInt_t &b, size_t s, Matrix &M) {
+        int i = a.raw_less(b);
+        BigInt_t &x = i ? b : a, &y = i ? a : b;
+        BigInt_t r = x - y;
+        if (r.size() <= s) return false;
+        BigInt_t q = r / y;
+        r -= q * y;
+        q.raw_add(BigInt_t(1));
+        if (r.size() <= s) {
+            r.raw_add(y);
+            q.raw_sub(BigInt_t(1));
+        }
+        x = r;
+        // M = M * (1, q; 0, 1) or M * (1, 0; q, 1)
+        M.m[0][!i] += q * M.m[0][i];
+        M.m[1][!i] += q * M.m[1][i];
+        return true;
+    }
+    static bool step(BigInt_t &a, BigInt_t &b, size_t s, Matrix &M) {
+        int64_t u[2][2];
+        if (!lehmer(a, b, s, u)) return subdiv(a, b, s, M);
+        apply(a, b, u);
+        mul_inverse(M, u);
+        return true;
+    }
+    // reduce a and b to about half of the length, (a; b) = M * (a'; b') and
+    // a', b' are at least COMPRESS_MOD^s, s = n / 2 + 1
+    static bool hgcd(BigInt_t &a, BigInt_t &b, Matrix &M) {
+        size_t n = std::max(a.size(), b.size()), s = n / 2 + 1;
+        bool reduced = false;
+        if (a.size() <= s || b.size() <= s) return false;
+        if (n >= BIGINT_HGCD_THRESHOLD) {
+            reduced = reduce(a, b, n / 2, M);
+            while (std::max(a.size(), b.size()) > n * 3 / 4 + 1) {
+                if (!step(a, b, s, M)) return reduced;
+                reduced = true;
+            }
+            size_t n2 = std::max(a.size(), b.size());
+            Matrix M1;
+            if (n2 > s + 2 && reduce(a, b, s * 2 - n2 + 1, M1)) {
+                M = M * M1;
+                reduced = true;
+            }
+        }
+        while (step(a, b, s, M))
+            reduced = true;
+        return reduced;
+    }
+    // hgcd on the limbs from p, then (a; b) = M^-1 * (a; b)
+    static bool reduce(BigInt_t &a, BigInt_t &b, size_t p, Matrix &M) {
+        BigInt_t ah = a.raw_shr_to(p), bh = b.raw_shr_to(p);
+        if (!hgcd(ah, bh, M)) return false;
+        BigInt_t al = a.raw_lowdigits_to(p), bl = b.raw_lowdigits_to(p);
+        a = M.m[1][1] * al - M.m[0][1] * bl + ah.raw_shl(p);
+        b = M.m[0][0] * bl - M.m[1][0] * al + bh.raw_shl(p);
+        return true;
+    }
+    // a = gcd(a, b) and b = 0 for a, b >= 0, c are the cofactors of a and b if not NULL
+    static void run(BigInt_t &a, BigInt_t &b, BigInt_t *c) {
+        for (;;) {
+            if (a.is_zero()) {
+                std::swap(a, b);
+                if (c) std::swap(c[0], c[1]);
+            }
+            if (b.is_zero()) return;
+            size_t n = std::max(a.size(), b.size());
+            Matrix M;
+            if (n >= BIGINT_GCD_THRESHOLD && reduce(a, b, n / 3, M)) {
+                if (c) {
+                    BigInt_t t = M.m[1][1] * c[0] - M.m[0][1] * c[1];
+                    c[1] = M.m[0][0] * c[1] - M.m[1][0] * c[0];
+                    c[0] = t;
+                }
+                continue;
+            }
+            int64_t u[2][2];
+            if (lehmer(a, b, 0, u)) {
+                apply(a, b, u);
+                if (c) apply_cofactor(c, u);
+                continue;
+            }
+            int i = a.raw_less(b);
+            BigInt_t &x = i ? b : a, &y = i ? a : b, q = x / y;
+            x -= q * y;
+            if (c) c[i] -= q * c[!i];
+        }
+    }
+
+public:
+    static BigInt_t gcd(const BigInt_t &a, const BigInt_t &b) {
+        BigInt_t x = a, y = b;
+        x.sign = y.sign = 1;
+        run(x, y, NULL);
+        return x;
+    }
+    // g = a * s + b * t, |s| < |b| / g if b is not 0, and s is 0 or has the sign of a
+    static BigInt_t gcdext(const BigInt_t &a, const BigInt_t &b, BigInt_t &s, BigInt_t &t) {
+        BigInt_t g = a, x = a, y = b, c[2];
+        g.sign = x.sign = y.sign = 1;
+        c[0].set(1);
+        run(g, y, c);
+        s = c[0];
+        y = b;
+        y.sign = 1;
+        if (y.is_zero()) {
+            t.set(0);
+        } else {
+            BigInt_t l = y / g;
+            s %= l;
+            if (s.sign < 0 && !s.is_zero()) s += l;
+            t = (g - s * x) / y;
+        }
+        if (!s.is_zero()) s.sign *= a.sign;
+        if (!t.is_zero()) t.sign *= b.sign;
+        return g;
+    }
+    // a^-1 mod m, or 0 if a and m are not coprime
+    static BigInt_t invert(const BigInt_t &a, const BigInt_t &m) {
+        BigInt_t s, t, x = m;
+        x.sign = 1;
+        if (x.is_zero() || gcdext(a, x, s, t) != BigInt_t(1)) return BigInt_t(0);
+        s %= x;
+        if (s.sign < 0 && !s.is_zero()) s += x;
+        return s;
+    }
+};
+
+// binary splitting of a series, gen(k, p, q, t) sets p(k), q(k) and t(k) = a(k) * p(k), then
+// T / Q = sum of a(k) * p(a) ... p(k) / (q(a) ... q(k)) for k in [a, b)
+// with threads > 1 the subtrees run in parallel, which needs C++11
+template <class Gen> class BigIntHexBinarySplit {
+    typedef BigIntHex BigInt_t;
+    const Gen &gen;
+    unsigned threads;
+
+#if BIGINT_THREADS
+    // an exception of the subtree is kept for the caller, it would terminate the program in the thread
+    struct Task {
+        const BigIntHexBinarySplit *bs;
+        uint64_t a, b;
+        std::vector<BigInt_t> *pqt;
+        bool need_p;
+        unsigned threads;
+        std::exception_ptr *error;
+        void operator()() const {
+            try {
+                pqt->resize(3);
+                bs->run(a, b, (*pqt)[0], (*pqt)[1], (*pqt)[2], need_p, threads);
+            } catch (...) {
+                *error = std::current_exception();
+            }
+        }
+    };
+    // joins the thread when the scope is left, also by an exception
+    struct Joiner {
+        std::thread &t;
+        ~Joiner() { t.join(); }
+    };
+#endif
+    // T = T1 * Q2 + P1 * T2, the left one keeps P1 for this
+    static void merge(BigInt_t &P, BigInt_t &Q, BigInt_t &T, const BigInt_t &P2, const BigInt_t &Q2,
+                      const BigInt_t &T2, bool need_p) {
+        T = T * Q2 + P * T2;
+        Q = Q * Q2;
+        if (need_p) P = P * P2;
+    }
+    void run(uint64_t a, uint64_t b, BigInt_t &P, BigInt_t &Q, BigInt_t &T, bool need_p, unsigned th) const {
+        if (b - a == 1) {
+            gen(a, P, Q, T);
+            return;
+        }
+        uint64_t m = a + (b - a) / 2;
+#if BIGINT_THREADS
+        if (th > 1) {
+            std::vector<BigInt_t> right_pqt;
+            std::exception_ptr error;
+            Task task = {this, m, b, &right_pqt, need_p, th / 2, &error};
+            std::thread right(task);
+            {
+                Joiner joiner = {right};
+                run(a, m, P, Q, T, true, th - th / 2);
+            }
+            if (error) std::rethrow_exception(error);
+            merge(P, Q, T, right_pqt[0], right_pqt[1], right_pqt[2], need_p);
+            return;
+        }
+#endif
+        BigInt_t P2, Q2, T2;
+        run(a, m, P, Q, T, true, 1);
+        run(m, b, P2, Q2, T2, need_p, 1);
+        merge(P, Q, T, P2, Q2, T2, need_p);
+    }
+
+public:
+    explicit BigIntHexBinarySplit(const Gen &g, unsigned th = 1) : gen(g), threads(th ? th : 1) {}
+    // P is skipped when need_p is false, the top level does not need it
+    void split(uint64_t a, uint64_t b, BigInt_t &P, BigInt_t &Q, BigInt_t &T, bool need_p = true) const {
+        if (a >= b) {
+            P.set(1);
+            Q.set(1);
+            T.set(0);
+            return;
+        }
+        run(a, b, P, Q, T, need_p, threads);
+    }
+    // the sum in fixed point, T * COMPRESS_MOD^limbs / Q rounded toward zero
+    BigInt_t sum(uint64_t a, uint64_t b, size_t limbs) const {
+        BigInt_t P, Q, T, r;
+        split(a, b, P, Q, T, false);
+        int sign = T.sign * Q.sign;
+        T.sign = Q.sign = 1;
+        r.raw_fastdiv(T.raw_shl(limbs), Q);
+        r.sign = sign;
+        if (r.is_zero()) r.sign = 1;
+        return r;
+    }
+};
+
+// a^e
+inline BigIntHex pow(const BigIntHex &a, uint64_t e) {
+    std::vector<uint32_t> w(2);
+    w[0] = (uint32_t)e;
+    w[1] = (uint32_t)(e >> 32);
+    return POW_NS::pow_window(POW_NS::mul_ctx<BigIntHex>(), a, w);
+}
+
+// a^e mod m, e should not be negative
+inline BigIntHex powmod(const BigIntHex &a, const BigIntHex &e, const BigIntHex &m) {
+    if ((m % BigIntHex(2)).is_zero()) {
+        BigIntHexBarrett barrett(m);
+        return barrett.pow(barrett.reduce(a), e);
+    }
+    BigIntHexMont mont(m);
+    return mont.from_mont(mont.pow(mont.to_mont(a), e));
+}
+
+// a * 2^n
+inline BigIntHex mul_2exp(const BigIntHex &a, uint64_t n) { return a << n; }
+
+// a / 2^n rounded toward negative infinity
+inline BigIntHex fdiv_q_2exp(const BigIntHex &a, uint64_t n) { return a >> n; }
+
+// a - trunc(a / 2^n) * 2^n, it has the sign of a
+inline BigIntHex tdiv_r_2exp(const BigIntHex &a, uint64_t n) {
+    BigIntHex r = a;
+    r.raw_mod_2exp(n);
+    if (r.is_zero()) r.sign = 1;
+    return r;
+}
+
+// floor(sqrt(a)), r = a - floor(sqrt(a))^2, a should not be negative
+inline BigIntHex isqrt_rem(const BigIntHex &a, BigIntHex &r) {
+    BigIntHex s;
+    if (a.sign < 0 || a.is_zero()) {
+        r = a;
+        return s;
+    }
+    s.raw_sqrt_rem(a, r);
+    return s;
+}
+
+// floor(sqrt(a)), a should not be negative
+inline BigIntHex isqrt(const BigIntHex &a) {
+    BigIntHex r;
+    return isqrt_rem(a, r);
+}
+
+// a^(1/k) rounded toward zero, k > 0, a should not be negative when k is even
+inline BigIntHex iroot(const BigIntHex &a, uint32_t k) {
+    BigIntHex s;
+    if (k == 1) return a;
+    if (a.is_zero() || (a.sign < 0 && k % 2 == 0)) return s;
+    BigIntHex t = a;
+    t.sign = 1;
+    s.raw_root(t, k);
+    s.sign = a.sign;
+    return s;
+}
+
+// a[0] * b[0] + a[1] * b[1] + ..., the pairs beyond the shorter vector are ignored
+inline BigIntHex dot(const std::vector<BigIntHex> &a, const std::vector<BigIntHex> &b) {
+    BigIntHex r;
+    return r.raw_dot(a, b);
+}
+
+// r = a * b for the polynomials with the coefficients from the lowest, by Kronecker substitution:
+// the coefficients go into slots of k limbs of one integer, k is large enough for any coefficient
+// of the product with its sign, and the slots of the product are read as signed values
+inline std::vector<BigIntHex> poly_mul(const std::vector<BigIntHex> &a, const std::vector<BigIntHex> &b) {
+    std::vector<BigIntHex> r;
+    if (a.empty() || b.empty()) return r;
+    size_t ba = 0, bb = 0;
+    for (size_t i = 0; i < a.size(); ++i)
+        ba = std::max(ba, a[i].bit_length());
+    for (size_t i = 0; i < b.size(); ++i)
+        bb = std::max(bb, b[i].bit_length());
+    size_t k = (ba + bb + NTT_NS::log2((uint32_t)std::min(a.size(), b.size())) + 2) / COMPRESS_BIT + 1;
+    // a polynomial is the slots of the positive coefficients minus the slots of the negative ones
+    BigIntHex x[2], y[2];
+    for (int s = 0; s < 2; ++s) {
+        x[s].v.assign(a.size() * k, 0);
+        y[s].v.assign(b.size() * k, 0);
+    }
+    for (size_t i = 0; i < a.size(); ++i)
+        std::copy(a[i].v.begin(), a[i].v.end(), x[a[i].sign < 0].v.begin() + i * k);
+    for (size_t i = 0; i < b.size(); ++i)
+        std::copy(b[i].v.begin(), b[i].v.end(), y[b[i].sign < 0].v.begin() + i * k);
+    for (int s = 0; s < 2; ++s) {
+        x[s].trim();
+        y[s].trim();
+    }
+    BigIntHex c = (x[0] - x[1]) * (y[0] - y[1]), slot_mod(1);
+    slot_mod.raw_shl(k);
+    r.resize(a.size() + b.size() - 1);
+    bool carry = false;
+    for (size_t i = 0; i < r.size(); ++i) {
+        BigIntHex &t = r[i];
+        size_t lo = std::min(c.size(), i * k), hi = std::min(c.size(), i * k + k);
+        t.v.assign(c.v.begin() + lo, c.v.begin() + hi);
+        if (t.v.empty()) t.v.push_back(0);
+        t.trim();
+        if (carry) t += BigIntHex(1);
+        // a slot at or above half of COMPRESS_MOD^k holds a negative coefficient, which borrowed from the next slot
+        carry = t.size() > k || (t.size() == k && t.v.back() >> (COMPRESS_BIT - 1));
+        if (carry) t -= slot_mod;
+        if (c.sign < 0) t = -t;
+    }
+    return r;
+}
+
+// the greatest common divisor, it is not negative
+inline BigIntHex gcd(const BigIntHex &a, const BigIntHex &b) { return BigIntHexGcd::gcd(a, b); }
+
+// g = gcd(a, b) = a * s + b * t
+inline BigIntHex gcdext(const BigIntHex &a, const BigIntHex &b, BigIntHex &s, BigIntHex &t) {
+    return BigIntHexGcd::gcdext(a, b, s, t);
+}
+
+// a^-1 mod m in [0, |m|), or 0 if a and m are not coprime
+inline BigIntHex invert(const BigIntHex &a, const BigIntHex &m) { return BigIntHexGcd::invert(a, m); }
+
+// Baillie-PSW test: trial division, the strong test to base 2 and the strong Lucas test,
+// there is no known pseudoprime and none below 2^64
+class BigIntHexPrime {
+public:
+    typedef BigIntHex BigInt_t;
+    // the primes up to this divide the candidates before the strong tests
+    static const uint32_t TRIAL_LIMIT = 4096;
+
+private:
+    typedef BigInt_t::base_t base_t;
+#if BIGINT_THREADS
+    struct Task {
+        const std::vector<BigInt_t> *c;
+        const std::vector<size_t> *idx;
+        std::vector<char> *r;
+        size_t begin, step;
+        void operator()() const {
+            for (size_t i = begin; i < idx->size(); i += step)
+                (*r)[(*idx)[i]] = strong_tests((*c)[(*idx)[i]]);
+        }
+    };
+#endif
+    // the Jacobi symbol (a / n) for the odd n > 0
+    static int jacobi(uint64_t a, uint64_t n) {
+        int j = 1;
+        for (a %= n; a != 0; a %= n) {
+            for (; (a & 1) == 0; a >>= 1)
+                if ((n & 7) == 3 || (n & 7) == 5) j = -j;
+            std::swap(a, n);
+            if ((a & 3) == 3 && (n & 3) == 3) j = -j;
+        }
+        return n == 1 ? j : 0;
+    }
+    static int jacobi(int64_t d, const BigInt_t &n) {
+        int j = 1;
+        base_t n8 = n.v[0] & 7;
+        uint64_t a = d < 0 ? -d : d;
+        if (d < 0 && (n8 & 3) == 3) j = -j;
+        for (; a != 0 && (a & 1) == 0; a >>= 1)
+            if (n8 == 3 || n8 == 5) j = -j;
+        if (a == 1) return j;
+        // reciprocity, then n mod a is small
+        if ((a & 3) == 3 && (n8 & 3) == 3) j = -j;
+        BigInt_t r = n % BigInt_t((intmax_t)a);
+        return j * jacobi(r.is_zero() ? 0 : r.v[0], a);
+    }
+    static void add_mod(BigInt_t &a, const BigInt_t &b, const BigInt_t &m) {
+        a.raw_add(b);
+        if (!a.raw_less(m)) a.raw_sub(m);
+    }
+    static void sub_mod(BigInt_t &a, const BigInt_t &b, const BigInt_t &m) {
+        if (a.raw_less(b)) a.raw_add(m);
+        a.raw_sub(b);
+    }
+    // a / 2 mod m, m is odd
+    static void half_mod(BigInt_t &a, const BigInt_t &m) {
+        if (a.v[0] & 1) a.raw_add(m);
+        a.raw_div_2exp(1);
+    }
+    // the strong test to base 2, n is odd
+    static bool strong_test(const BigInt_t &n, const BigIntHexMont &mont) {
+        BigInt_t n1 = n - BigInt_t(1);
+        size_t s = n1.count_trailing_zeros();
+        BigInt_t one = mont.one(), minus_one = n - one;
+        BigInt_t x = mont.pow(mont.to_mont(BigInt_t(2)), n1 >> s);
+        if (x == one || x == minus_one) return true;
+        for (size_t i = 1; i < s; ++i) {
+            x = mont.sqr(x);
+            if (x == minus_one) return true;
+            if (x == one) return false;
+        }
+        return false;
+    }
+    // the strong Lucas test with P = 1 and Q = (1 - D) / 4, Selfridge's choice of D
+    static bool lucas_test(const BigInt_t &n, const BigIntHexMont &mont) {
+        int64_t d = 5;
+        for (int j; (j = jacobi(d, n)) != -1; d = d > 0 ? -d - 2 : -d + 2) {
+            if (j == 0) return false;
+            // there is no such D for the squares
+            if (d == 13) {
+                BigInt_t s = isqrt(n);
+                if (s * s == n) return false;
+            }
+        }
+        BigInt_t n1 = n + BigInt_t(1);
+        size_t s = n1.count_trailing_zeros();
+        std::vector<base_t> w = (n1 >> s).raw_words();
+        BigInt_t dm = mont.to_mont(BigInt_t((intmax_t)d)), qm = mont.to_mont(BigInt_t((intmax_t)((1 - d) / 4)));
+        // U(k), V(k) and Q^k in Montgomery form, from k = 1
+        BigInt_t u = mont.one(), v = u, qk = qm, t;
+        for (size_t i = POW_NS::bit_length(w) - 1; i-- > 0;) {
+            // k -> 2k
+            u = mont.mul(u, v);
+            v = mont.sqr(v);
+            t = qk;
+            add_mod(t, qk, n);
+            sub_mod(v, t, n);
+            qk = mont.sqr(qk);
+            if ((w[i / 32] >> (i % 32)) & 1) {
+                // k -> k + 1
+                t = mont.mul(dm, u);
+                add_mod(u, v, n);
+                half_mod(u, n);
+                add_mod(v, t, n);
+                half_mod(v, n);
+                qk = mont.mul(qk, qm);
+            }
+        }
+        if (u.is_zero() || v.is_zero()) return true;
+        for (size_t r = 1; r < s; ++r) {
+            v = mont.sqr(v);
+            t = qk;
+            add_mod(t, qk, n);
+            sub_mod(v, t, n);
+            if (v.is_zero()) return true;
+            qk = mont.sqr(qk);
+        }
+        return false;
+    }
+    // n is odd and has no factor up to TRIAL_LIMIT
+    static bool strong_tests(const BigInt_t &n) {
+        BigIntHexMont mont(n);
+        return strong_test(n, mont) && lucas_test(n, mont);
+    }
+    static const std::vector<uint32_t> &small_primes() {
+        static const std::vector<uint32_t> pr = COMB_NS::primes(TRIAL_LIMIT);
+        return pr;
+    }
+    static BigInt_t make_trial_product() {
+        const std::vector<uint32_t> &pr = small_primes();
+        std::vector<uint64_t> f;
+        for (size_t i = 0; i < pr.size(); ++i)
+            COMB_NS::push_factor(f, pr[i]);
+        return COMB_NS::product<BigInt_t>(f, 0, f.size());
+    }
+    // the product of the primes up to TRIAL_LIMIT, built on the first call
+    static const BigInt_t &trial_product() {
+        static const BigInt_t p = make_trial_product();
+        return p;
+    }
+    // 1 for a small prime, 0 for a small number, -1 if n is larger than TRIAL_LIMIT
+    static int small_case(const BigInt_t &n) {
+        if (n.size() > 1 || n.v[0] > TRIAL_LIMIT) return -1;
+        const std::vector<uint32_t> &pr = small_primes();
+        return std::binary_search(pr.begin(), pr.end(), n.v[0]) ? 1 : 0;
+    }
+
+public:
+    static bool is_probable_prime(const BigInt_t &a) {
+        BigInt_t n = a;
+        n.sign = 1;
+        int sc = small_case(n);
+        if (sc >= 0) return sc == 1;
+        if (BigIntHexGcd::gcd(trial_product() % n, n) != BigInt_t(1)) return false;
+        return strong_tests(n);
+    }
+    // r[i] = is_probable_prime(c[i]), the strong tests of the candidates run in parallel
+    static std::vector<char> is_probable_prime(const std::vector<BigInt_t> &c, unsigned threads = 1) {
+        std::vector<char> r(c.size());
+        std::vector<BigInt_t> n;
+        std::vector<size_t> idx;
+        for (size_t i = 0; i < c.size(); ++i) {
+            BigInt_t t = c[i];
+            t.sign = 1;
+            int sc = small_case(t);
+            if (sc >= 0) {
+                r[i] = (char)sc;
+            } else {
+                n.push_back(t);
+                idx.push_back(i);
+            }
+        }
+        if (n.empty()) return r;
+        // remainder tree, the product of the small primes mod each candidate
+        std::vector<std::vector<BigInt_t> > tree(1, n);
+        while (tree.back().size() > 1) {
+            const std::vector<BigInt_t> &b = tree.back();
+            std::vector<BigInt_t> up((b.size() + 1) / 2);
+            for (size_t i = 0; i < up.size(); ++i)
+                up[i] = i * 2 + 1 < b.size() ? b[i * 2] * b[i * 2 + 1] : b[i * 2];
+            tree.push_back(up);
+        }
+        std::vector<BigInt_t> rem(1, trial_product() % tree.back()[0]);
+        for (size_t k = tree.size() - 1; k-- > 0;) {
+            std::vector<BigInt_t> down(tree[k].size());
+            for (size_t i = 0; i < down.size(); ++i)
+                down[i] = rem[i / 2] % tree[k][i];
+            rem.swap(down);
+        }
+        std::vector<size_t> rest;
+        for (size_t i = 0; i < n.size(); ++i)
+            if (BigIntHexGcd::gcd(rem[i], n[i]) == BigInt_t(1)) rest.push_back(i);
+        std::vector<char> pass(n.size());
+#if BIGINT_THREADS
+        size_t th = std::min((size_t)(threads ? threads : 1), rest.size());
+        std::vector<std::thread> pool;
+        for (size_t t = 1; t < th; ++t) {
+            Task task = {&n, &rest, &pass, t, th};
+            pool.push_back(std::thread(task));
+        }
+        Task task = {&n, &rest, &pass, 0, th ? th : 1};
+        task();
+        for (size_t t = 0; t < pool.size(); ++t)
+            pool[t].join();
+#else
+        (void)threads;
+        for (size_t i = 0; i < rest.size(); ++i)
+            pass[rest[i]] = strong_tests(n[rest[i]]);
+#endif
+        for (size_t i = 0; i < n.size(); ++i)
+            r[idx[i]] = pass[i];
+        return r;
+    }
+};
+
+// false if a is composite, true if a is a probable prime, |a| is tested
+inline bool is_probable_prime(const BigIntHex &a) { return BigIntHexPrime::is_probable_prime(a); }
+
+// is_probable_prime for each candidate, with threads > 1 they run in parallel, which needs C++11
+inline std::vector<char> is_probable_prime(const std::vector<BigIntHex> &c, unsigned threads = 1) {
+    return BigIntHexPrime::is_probable_prime(c, threads);
+}
+
+// fixed width unsigned integer of BITS bits with inline limbs, BITS should be a multiple of 32.
+// the arithmetic wraps around modulo 2^BITS like the built-in unsigned types.
+// add, sub and mul are unrolled at compile time, div, mod and the strings go through BigIntHex
+template <size_t BITS> class BigIntHexFixed {
+protected:
+    typedef uint32_t base_t;
+    typedef int64_t carry_t;
+    typedef uint64_t ucarry_t;
+    typedef BigIntHex BigInt_t;
+    typedef BigIntHexFixed Fixed_t;
+    enum { N = BITS / 32, UNROLL_ROWS = N <= 16 }; // the rows of wider numbers stay loops, for the compile time
+    typedef char bits_check[BITS % 32 == 0 && BITS > 0 && COMPRESS_BIT == 32 ? 1 : -1];
+    base_t v[N];
+
+    // the loops run from idx<I> to idx<N>, the overload for the end stops the recursion
+    template <size_t I> struct idx {};
+    template <size_t I> static void raw_add(base_t *r, const base_t *b, ucarry_t &add, idx<I>) {
+        BigInt_t::carry(add, r[I], (ucarry_t)r[I] + b[I]);
+        raw_add(r, b, add, idx<I + 1>());
+    }
+    static void raw_add(base_t *, const base_t *, ucarry_t &, idx<N>) {}
+    template <size_t I> static void raw_sub(base_t *r, const base_t *b, carry_t &add, idx<I>) {
+        BigInt_t::borrow(add, r[I], (carry_t)r[I] - b[I]);
+        raw_sub(r, b, add, idx<I + 1>());
+    }
+    static void raw_sub(base_t *, const base_t *, carry_t &, idx<N>) {}
+    // r[0..E) += x * b[0..E), the carry out of the top is dropped
+    template <size_t J, size_t E> static void raw_row(base_t *r, ucarry_t x, const base_t *b, ucarry_t &add, idx<J>, idx<E>) {
+        BigInt_t::carry(add, r[J], r[J] + x * b[J]);
+        raw_row(r, x, b, add, idx<J + 1>(), idx<E>());
+    }
+    template <size_t E> static void raw_row(base_t *, ucarry_t, const base_t *, ucarry_t &, idx<E>, idx<E>) {}
+    // r = a * b mod 2^BITS, only the rows below the width are computed
+    template <size_t I> static void raw_mul(base_t *r, const base_t *a, const base_t *b, idx<I>) {
+        ucarry_t add = 0;
+        if (UNROLL_ROWS) {
+            raw_row(r + I, a[I], b, add, idx<0>(), idx<UNROLL_ROWS ? N - I : 0>());
+        } else {
+            for (size_t j = 0; j < N - I; ++j)
+                BigInt_t::carry(add, r[I + j], r[I + j] + a[I] * (ucarry_t)b[j]);
+        }
+        raw_mul(r, a, b, idx<I + 1>());
+    }
+    static void raw_mul(base_t *, const base_t *, const base_t *, idx<N>) {}
+    // the kernels of the integer operators, the operand keeps its sign like with BigIntHex,
+    // x op n is BigIntHexFixed(x.to_bigint() op n)
+    int raw_cmp_small(bool neg, uint64_t m) const {
+        if (neg && m) return 1;
+        for (size_t i = N; i-- > 2;)
+            if (v[i]) return 1;
+        uint64_t x = 0;
+        for (size_t i = std::min((size_t)N, (size_t)2); i-- > 0;)
+            x = x << 32 | v[i];
+        return x < m ? -1 : x > m;
+    }
+    Fixed_t &raw_add_small(bool neg, uint64_t m) {
+        if (neg) {
+            carry_t add = 0;
+            for (size_t i = 0; i < N && (m || add); ++i, m = high_digit(m))
+                BigInt_t::borrow(add, v[i], (carry_t)v[i] - (carry_t)low_digit(m));
+        } else {
+            ucarry_t add = 0;
+            for (size_t i = 0; i < N && (m || add); ++i, m = high_digit(m))
+                BigInt_t::carry(add, v[i], (ucarry_t)v[i] + low_digit(m));
+        }
+        return *this;
+    }
+    Fixed_t &raw_mul_small(bool neg, uint64_t m) {
+        Fixed_t r;
+        for (size_t i = 0; i < 2 && i < N; ++i, m = high_digit(m)) {
+            ucarry_t add = 0, x = low_digit(m);
+            for (size_t j = 0; x && i + j < N; ++j)
+                BigInt_t::carry(add, r.v[i + j], r.v[i + j] + x * v[j]);
+        }
+        *this = r;
+        return neg ? inv() : *this;
+    }
+    Fixed_t &raw_div_small(bool neg, uint64_t m) {
+        if (m > ~(uint64_t)0 / COMPRESS_MOD) {
+            BigInt_t t = to_bigint();
+            from_bigint(t /= m);
+        } else {
+            uint64_t r = 0;
+            for (size_t i = N; i-- > 0;) {
+                r = r << 32 | v[i];
+                v[i] = (base_t)(r / m);
+                r %= m;
+            }
+        }
+        return neg ? inv() : *this;
+    }
+    Fixed_t &raw_mod_small(uint64_t m) {
+        if (m > ~(uint64_t)0 / COMPRESS_MOD) {
+            BigInt_t t = to_bigint();
+            return from_bigint(t %= m);
+        }
+        uint64_t r = 0;
+        for (size_t i = N; i-- > 0;)
+            r = (r << 32 | v[i]) % m;
+        std::fill(v, v + N, 0);
+        v[0] = (base_t)r;
+        return *this;
+    }
+
+public:
+    BigIntHexFixed() { std::fill(v, v + N, 0); }
+    explicit BigIntHexFixed(int n) { set(n); }
+    explicit BigIntHexFixed(intmax_t n) { set(n); }
+    explicit BigIntHexFixed(const char *s, int base = 10) { from_str(s, base); }
+    explicit BigIntHexFixed(const std::string &s, int base = 10) { from_str(s, base); }
+    // a modulo 2^BITS
+    explicit BigIntHexFixed(const BigInt_t &a) { from_bigint(a); }
+    Fixed_t &set(intmax_t n) {
+        uint64_t s = bigint_int_abs((int64_t)n);
+        std::fill(v, v + N, 0);
+        for (size_t i = 0; i < N && s; ++i, s = high_digit(s))
+            v[i] = low_digit(s);
+        return n < 0 ? inv() : *this;
+    }
+    Fixed_t &from_bigint(const BigInt_t &a) {
+        size_t k = std::min(a.size(), (size_t)N);
+        std::copy(a.v.begin(), a.v.begin() + k, v);
+        std::fill(v + k, v + N, 0);
+        return a.sign < 0 ? inv() : *this;
+    }
+    BigInt_t to_bigint() const {
+        BigInt_t r;
+        r.v.assign(v, v + N);
+        r.trim();
+        return r;
+    }
+    Fixed_t &from_str(const char *s, int base = 10) { return from_bigint(BigInt_t(s, base)); }
+    Fixed_t &from_str(const std::string &s, int base = 10) { return from_str(s.c_str(), base); }
+    std::string to_str(int32_t out_base = 10, int32_t pack = 0) const { return to_bigint().to_str(out_base, pack); }
+    bool is_zero() const { return std::count(v, v + N, (base_t)0) == N; }
+    bool operator<(const Fixed_t &b) const {
+        for (size_t i = N; i-- > 0;)
+            if (v[i] != b.v[i]) return v[i] < b.v[i];
+        return false;
+    }
+    bool operator==(const Fixed_t &b) const { return std::equal(v, v + N, b.v); }
+    LESS_THAN_AND_EQUAL_COMPARABLE(Fixed_t)
+
+    Fixed_t &operator=(intmax_t n) { return set(n); }
+    Fixed_t &operator=(const char *s) { return from_str(s); }
+    Fixed_t &operator+=(const Fixed_t &b) {
+        ucarry_t add = 0;
+        raw_add(v, b.v, add, idx<0>());
+        return *this;
+    }
+    Fixed_t &operator-=(const Fixed_t &b) {
+        carry_t add = 0;
+        raw_sub(v, b.v, add, idx<0>());
+        return *this;
+    }
+    Fixed_t &operator*=(const Fixed_t &b) {
+        Fixed_t r;
+        raw_mul(r.v, v, b.v, idx<0>());
+        return *this = r;
+    }
+    Fixed_t &operator/=(const Fixed_t &b) { return from_bigint(to_bigint() / b.to_bigint()); }
+    Fixed_t &operator%=(const Fixed_t &b) { return from_bigint(to_bigint() % b.to_bigint()); }
+    Fixed_t operator+(const Fixed_t &b) const { return Fixed_t(*this) += b; }
+    Fixed_t operator-(const Fixed_t &b) const { return Fixed_t(*this) -= b; }
+    Fixed_t operator*(const Fixed_t &b) const {
+        Fixed_t r;
+        raw_mul(r.v, v, b.v, idx<0>());
+        return r;
+    }
+    Fixed_t operator/(const Fixed_t &b) const { return Fixed_t(*this) /= b; }
+    Fixed_t operator%(const Fixed_t &b) const { return Fixed_t(*this) %= b; }
+    // 2^BITS - *this
+    Fixed_t &inv() {
+        Fixed_t r;
+        return *this = r -= *this;
+    }
+    Fixed_t operator-() const { return Fixed_t() -= *this; }
+    BIGINT_ALL_INT_OPERATORS(Fixed_t)
+    Fixed_t &operator<<=(uint64_t n) {
+        if (n >= BITS) return *this = Fixed_t();
+        size_t k = (size_t)(n / 32), s = (size_t)(n % 32);
+        for (size_t i = N; i-- > k;)
+            v[i] = (v[i - k] << s) | (s && i > k ? v[i - k - 1] >> (32 - s) : 0);
+        std::fill(v, v + k, 0);
+        return *this;
+    }
+    Fixed_t &operator>>=(uint64_t n) {
+        if (n >= BITS) return *this = Fixed_t();
+        size_t k = (size_t)(n / 32), s = (size_t)(n % 32);
+        for (size_t i = 0; i + k < N; ++i)
+            v[i] = (v[i + k] >> s) | (s && i + k + 1 < N ? v[i + k + 1] << (32 - s) : 0);
+        std::fill(v + N - k, v + N, 0);
+        return *this;
+    }
+    Fixed_t operator<<(uint64_t n) const { return Fixed_t(*this) <<= n; }
+    Fixed_t operator>>(uint64_t n) const { return Fixed_t(*this) >>= n; }
+    Fixed_t &operator&=(const Fixed_t &b) {
+        for (size_t i = 0; i < N; ++i)
+            v[i] &= b.v[i];
+        return *this;
+    }
+    Fixed_t &operator|=(const Fixed_t &b) {
+        for (size_t i = 0; i < N; ++i)
+            v[i] |= b.v[i];
+        return *this;
+    }
+    Fixed_t &operator^=(const Fixed_t &b) {
+        for (size_t i = 0; i < N; ++i)
+            v[i] ^= b.v[i];
+        return *this;
+    }
+    Fixed_t operator&(const Fixed_t &b) const { return Fixed_t(*this) &= b; }
+    Fixed_t operator|(const Fixed_t &b) const { return Fixed_t(*this) |= b; }
+    Fixed_t operator^(const Fixed_t &b) const { return Fixed_t(*this) ^= b; }
+    Fixed_t operator~() const {
+        Fixed_t r;
+        for (size_t i = 0; i < N; ++i)
+            r.v[i] = ~v[i];
+        return r;
+    }
+};
+
+// sums of many integers, the limbs are added into 64 bit lanes without carrying
+// and the lanes are only normalised before one could overflow, or on readout
+class BigIntHexAccum {
+protected:
+    typedef BigIntHex BigInt_t;
+    typedef uint32_t base_t;
+    std::vector<int64_t> lanes;
+    uint64_t bound; // no lane is larger than this in absolute value
+
+    // a lane is kept below 2^62, the carries of a normalisation can not overflow
+    static uint64_t limit() { return (uint64_t)1 << 62; }
+    void reserve(size_t n, uint64_t add) {
+        if (bound > limit() - add) normalize();
+        bound += add;
+        if (lanes.size() <= n) lanes.resize(n + 1);
+    }
+
+public:
+    BigIntHexAccum() : bound(0) {}
+    void clear() {
+        lanes.clear();
+        bound = 0;
+    }
+    // the lanes below the top one are in [0, COMPRESS_MOD) afterwards
+    BigIntHexAccum &normalize() {
+        int64_t c = 0;
+        for (size_t i = 0; i + 1 < lanes.size(); ++i) {
+            int64_t t = lanes[i] + c, r = t % (int64_t)COMPRESS_MOD;
+            c = t / (int64_t)COMPRESS_MOD;
+            if (r < 0) r += (int64_t)COMPRESS_MOD, --c;
+            lanes[i] = r;
+        }
+        if (lanes.empty()) return *this;
+        lanes.back() += c;
+        while (lanes.back() >= (int64_t)COMPRESS_MOD || lanes.back() <= -(int64_t)COMPRESS_MOD) {
+            int64_t t = lanes.back(), r = t % (int64_t)COMPRESS_MOD;
+            c = t / (int64_t)COMPRESS_MOD;
+            if (r < 0) r += (int64_t)COMPRESS_MOD, --c;
+            lanes.back() = r;
+            lanes.push_back(c);
+        }
+        bound = COMPRESS_MOD;
+        return *this;
+    }
+    // += m * a
+    BigIntHexAccum &addmul(const BigInt_t &a, int32_t m) {
+        if (m == 0 || a.is_zero()) return *this;
+        uint64_t am = m < 0 ? 0 - (uint64_t)m : (uint64_t)m;
+        if (am >= (uint64_t)1 << 29) { // (COMPRESS_MOD - 1) * m stays far below the limit
+            addmul(a, m / 2);
+            return addmul(a, m - m / 2);
+        }
+        reserve(a.size(), (COMPRESS_MOD - 1) * am);
+        int64_t sm = a.sign < 0 ? -(int64_t)m : (int64_t)m;
+        int64_t *p = &lanes[0];
+        const base_t *q = &a.v[0];
+        if (sm == 1)
+            for (size_t i = 0; i < a.size(); ++i)
+                p[i] += q[i];
+        else if (sm == -1)
+            for (size_t i = 0; i < a.size(); ++i)
+                p[i] -= q[i];
+        else
+            for (size_t i = 0; i < a.size(); ++i)
+                p[i] += q[i] * sm;
+        return *this;
+    }
+    BigIntHexAccum &operator+=(const BigInt_t &a) { return addmul(a, 1); }
+    BigIntHexAccum &operator-=(const BigInt_t &a) { return addmul(a, -1); }
+    BigInt_t value() const {
+        BigIntHexAccum t(*this);
+        t.normalize();
+        BigInt_t r;
+        if (t.lanes.empty()) return r;
+        r.v.resize(t.lanes.size());
+        for (size_t i = 0; i + 1 < t.lanes.size(); ++i)
+            r.v[i] = (base_t)t.lanes[i];
+        int64_t top = t.lanes.back();
+        r.v.back() = (base_t)(top < 0 ? 0 : top);
+        r.trim();
+        if (top < 0) {
+            BigInt_t h((intmax_t)-top);
+            h.raw_shl(t.lanes.size() - 1);
+            r -= h;
+        }
+        return r;
+    }
+};
+
+// starts an expression template, r = lazy(a) * b + c is evaluated into r
+inline EXPR_NS::Ref<BigIntHex> lazy(const BigIntHex &a) { return EXPR_NS::Ref<BigIntHex>(a); }
 } // namespace BigIntHexNS
 
 using BigIntHexNS::BigIntHex;
+using BigIntHexNS::BigIntHexMont;
+using BigIntHexNS::BigIntHexBarrett;
+using BigIntHexNS::BigIntHexPowTable;
+using BigIntHexNS::BigIntHexGcd;
+using BigIntHexNS::BigIntHexBinarySplit;
+using BigIntHexNS::BigIntHexPrime;
+using BigIntHexNS::BigIntHexFixed;
+using BigIntHexNS::BigIntHexAccum;
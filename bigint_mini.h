@@ -21,10 +21,11 @@ template <typename T> inline uint32_t low_digit(T digit) { return (uint32_t)(dig
 class BigIntMini {
 protected:
     typedef uint32_t base_t;
+    typedef BigIntLimbView<base_t> view_t;
     typedef int32_t carry_t;
     typedef uint32_t ucarry_t;
     int sign;
-    std::vector<base_t> v;
+    BigIntLimbs<base_t, BIGINT_INLINE_LIMBS> v;
     typedef BigIntMini BigInt_t;
     template <typename _Tx, typename _Ty> static inline void carry(_Tx &add, _Ty &baseval, _Tx newval) {
         add += newval;
@@ -36,7 +37,26 @@ protected:
         baseval = (_Tx)low_digit(add) + COMPRESS_MOD - 1;
         add = high_digit(add);
     }
+    // carry and borrow for a sum of two limbs, the carry is at most 1 so compares replace the division.
+    // the carry out is found from newval, only the and/or with the carry in is a serial dependency
+    template <typename _Tx, typename _Ty> static inline void carry1(_Tx &add, _Ty &baseval, _Tx newval) {
+        _Tx c = (newval >= (_Tx)COMPRESS_MOD) | ((newval == (_Tx)COMPRESS_MOD - 1) & add);
+        baseval = (_Ty)(newval + add - ((_Tx)COMPRESS_MOD & (0 - c)));
+        add = c;
+    }
+    template <typename _Tx, typename _Ty> static inline void borrow1(_Tx &add, _Ty &baseval, _Tx newval) {
+        _Tx c = (newval < 0) | ((newval == 0) & -add);
+        baseval = (_Ty)(newval + add + ((_Tx)COMPRESS_MOD & (0 - c)));
+        add = -c;
+    }
 
+    operator view_t() const { return raw_view(); }
+    view_t raw_view() const { return view_t(&v[0], size(), sign); }
+    BigInt_t &raw_assign(const view_t &a) {
+        v.assign(a.v, a.v + a.size());
+        sign = a.sign;
+        return *this;
+    }
     bool raw_less(const BigInt_t &b) const {
         if (v.size() != b.size()) return v.size() < b.size();
         for (size_t i = v.size() - 1; i < v.size(); i--)
@@ -49,38 +69,42 @@ protected:
             if (v[i] != b.v[i]) return false;
         return true;
     }
-    BigInt_t &raw_add(const BigInt_t &b) {
+    BigInt_t &raw_add(const view_t &b) {
+        v.unshare();
         if (v.size() < b.size()) v.resize(b.size());
         ucarry_t add = 0;
-        for (size_t i = 0; i < b.v.size(); i++)
-            carry(add, v[i], (ucarry_t)(v[i] + b.v[i]));
-        for (size_t i = b.v.size(); add && i < v.size(); i++)
-            carry(add, v[i], (ucarry_t)v[i]);
+        for (size_t i = 0; i < b.size(); i++)
+            carry1(add, v[i], (ucarry_t)(v[i] + b.v[i]));
+        for (size_t i = b.size(); add && i < v.size(); i++)
+            carry1(add, v[i], (ucarry_t)v[i]);
         add ? v.push_back((base_t)add) : trim();
         return *this;
     }
     BigInt_t &raw_offset_add(const BigInt_t &b, size_t offset) {
+        v.unshare();
         ucarry_t add = 0;
         for (size_t i = 0; i < b.size(); ++i)
-            carry(add, v[i + offset], (ucarry_t)(v[i + offset] + b.v[i]));
+            carry1(add, v[i + offset], (ucarry_t)(v[i + offset] + b.v[i]));
         for (size_t i = b.size() + offset; add; ++i)
-            carry(add, v[i], (ucarry_t)v[i]);
+            carry1(add, v[i], (ucarry_t)v[i]);
         return *this;
     }
     BigInt_t &raw_sub(const BigInt_t &b) {
+        v.unshare();
         if (v.size() < b.v.size()) v.resize(b.v.size());
         carry_t add = 0;
         for (size_t i = 0; i < b.v.size(); i++)
-            borrow(add, v[i], (carry_t)v[i] - (carry_t)b.v[i]);
+            borrow1(add, v[i], (carry_t)v[i] - (carry_t)b.v[i]);
         for (size_t i = b.v.size(); add && i < v.size(); i++)
-            borrow(add, v[i], (carry_t)v[i]);
+            borrow1(add, v[i], (carry_t)v[i]);
         if (add) {
             sign = -sign;
             add = 1;
             for (size_t i = 0; i < v.size(); i++)
-                carry(add, v[i], (carry_t)(COMPRESS_MOD - v[i] - 1));
+                carry1(add, v[i], (carry_t)(COMPRESS_MOD - v[i] - 1));
         }
         trim();
+        if (is_zero()) sign = 1;
         return *this;
     }
     BigInt_t &raw_mul_int(uint32_t m) {
@@ -89,13 +113,14 @@ protected:
             return *this;
         } else if (m == 1)
             return *this;
+        v.unshare();
         ucarry_t add = 0;
         for (size_t i = 0; i < v.size(); i++)
             carry(add, v[i], v[i] * (ucarry_t)m);
         if (add) v.push_back((base_t)add);
         return *this;
     }
-    BigInt_t &raw_mul(const BigInt_t &a, const BigInt_t &b) {
+    BigInt_t &raw_mul(const view_t &a, const view_t &b) {
         v.clear();
         v.resize(a.size() + b.size());
         for (size_t i = 0; i < a.size(); i++) {
@@ -108,18 +133,17 @@ protected:
         return *this;
     }
     // Karatsuba algorithm
-    BigInt_t &raw_mul_karatsuba(const BigInt_t &a, const BigInt_t &b) {
+    BigInt_t &raw_mul_karatsuba(const view_t &a, const view_t &b) {
         if (std::min(a.size(), b.size()) <= BIGINT_MUL_THRESHOLD) return raw_mul(a, b);
-        BigInt_t ah, al, bh, bl, h, m;
+        BigInt_t h, m, sa, sb;
         size_t split = std::max(std::min((a.size() + 1) / 2, b.size() - 1), std::min(a.size() - 1, (b.size() + 1) / 2));
-        al.v.assign(a.v.begin(), a.v.begin() + split);
-        ah.v.assign(a.v.begin() + split, a.v.end());
-        bl.v.assign(b.v.begin(), b.v.begin() + split);
-        bh.v.assign(b.v.begin() + split, b.v.end());
+        view_t al = a.low(split), ah = a.shr(split), bl = b.low(split), bh = b.shr(split);
 
         raw_mul_karatsuba(al, bl);
         h.raw_mul_karatsuba(ah, bh);
-        m.raw_mul_karatsuba(al + ah, bl + bh);
+        sa.raw_assign(al).raw_add(ah);
+        sb.raw_assign(bl).raw_add(bh);
+        m.raw_mul_karatsuba(sa, sb);
         m.raw_sub(*this);
         m.raw_sub(h);
         v.resize(a.size() + b.size());
@@ -182,51 +206,154 @@ protected:
         BigInt_t r;
         if (n >= size()) return r;
         r.v.assign(v.begin() + n, v.end());
-        return BIGINT_STD_MOVE(r);
+        return r;
     }
     BigInt_t &raw_shl(size_t n) {
         if (n == 0 || is_zero()) return *this;
         v.insert(v.begin(), n, 0);
         return *this;
     }
+    // limb range kernels used by the divide and conquer division
+    static bool raw_less_n(const base_t *a, const base_t *b, size_t n) {
+        for (size_t i = n - 1; i < n; i--)
+            if (a[i] != b[i]) return a[i] < b[i];
+        return false; // eq
+    }
+    static base_t raw_add_n(base_t *r, const base_t *b, size_t n) {
+        ucarry_t add = 0;
+        for (size_t i = 0; i < n; i++)
+            carry(add, r[i], (ucarry_t)r[i] + b[i]);
+        return (base_t)add;
+    }
+    static base_t raw_sub_n(base_t *r, const base_t *b, size_t n) {
+        carry_t add = 0;
+        for (size_t i = 0; i < n; i++)
+            borrow(add, r[i], (carry_t)r[i] - (carry_t)b[i]);
+        return (base_t)-add;
+    }
+    static base_t raw_dec_n(base_t *r, size_t n) {
+        for (size_t i = 0; i < n; i++) {
+            if (r[i]) {
+                --r[i];
+                return 0;
+            }
+            r[i] = COMPRESS_MOD - 1;
+        }
+        return 1;
+    }
+    // r[0, an + bn) = a * b, ws[0..2] are scratch numbers which keep their capacity
+    static void raw_mul_n(base_t *r, const base_t *a, size_t an, const base_t *b, size_t bn, BigInt_t *ws) {
+        if (std::min(an, bn) <= BIGINT_MUL_THRESHOLD) {
+            std::fill(r, r + an + bn, 0);
+            for (size_t i = 0; i < an; i++) {
+                ucarry_t add = 0, av = a[i];
+                for (size_t j = 0; j < bn; ++j)
+                    carry(add, r[i + j], r[i + j] + av * b[j]);
+                r[i + bn] = (base_t)add;
+            }
+            return;
+        }
+        ws[0].v.assign(a, a + an);
+        ws[0].trim();
+        ws[1].v.assign(b, b + bn);
+        ws[1].trim();
+        ws[2].raw_mul_karatsuba(ws[0], ws[1]);
+        std::copy(ws[2].v.begin(), ws[2].v.end(), r);
+        std::fill(r + ws[2].size(), r + an + bn, 0);
+    }
+    // schoolbook division of a[0, an) by the normalized b[0, bn), the quotient is
+    // written to q[0, an - bn) and the returned high limb, the remainder is left in a[0, bn)
+    static base_t raw_div_basecase(base_t *q, base_t *a, size_t an, const base_t *b, size_t bn) {
+        base_t qh = !raw_less_n(a + an - bn, b, bn);
+        if (qh) raw_sub_n(a + an - bn, b, bn);
+        ucarry_t b1 = b[bn - 1], b0 = b[bn - 2];
+        for (size_t i = an - bn - 1; i < an; i--) {
+            base_t *p = a + i;
+            ucarry_t rm = (ucarry_t)p[bn] * COMPRESS_MOD + p[bn - 1], m, rem;
+            if (p[bn] >= b1) {
+                m = COMPRESS_MOD - 1;
+                rem = rm - m * b1;
+            } else {
+                m = rm / b1;
+                rem = rm - m * b1;
+            }
+            while (rem < COMPRESS_MOD && m * b0 > rem * COMPRESS_MOD + p[bn - 2]) {
+                --m;
+                rem += b1;
+            }
+            ucarry_t mul = 0;
+            carry_t add = 0;
+            for (size_t j = 0; j < bn; j++) {
+                mul += m * b[j];
+                borrow(add, p[j], (carry_t)p[j] - (carry_t)low_digit(mul));
+                mul = high_digit(mul);
+            }
+            borrow(add, p[bn], (carry_t)p[bn] - (carry_t)mul);
+            if (add) {
+                --m;
+                raw_add_n(p, b, bn);
+            }
+            p[bn] = 0;
+            q[i] = (base_t)m;
+        }
+        return qh;
+    }
+    // Burnikel-Ziegler 2n/1n division, a[0, 2n) / b[0, n), the quotient is written to
+    // q[0, n) and the returned high limb, the remainder is left in a[0, n)
+    // tp is a workspace of n limbs shared by all the recursion levels
+    static base_t raw_div_2n1n(base_t *q, base_t *a, const base_t *b, size_t n, base_t *tp, BigInt_t *ws) {
+        if (n <= BIGINT_DIVIDEDIV_THRESHOLD) return raw_div_basecase(q, a, n * 2, b, n);
+        size_t lo = n / 2, hi = n - lo;
+        // 3n/2n step on the high half
+        base_t qh = raw_div_2n1n(q + lo, a + lo * 2, b + lo, hi, tp, ws);
+        raw_mul_n(tp, q + lo, hi, b, lo, ws);
+        base_t cy = raw_sub_n(a + lo, tp, n);
+        if (qh) cy += raw_sub_n(a + n, b, lo);
+        while (cy) {
+            qh -= raw_dec_n(q + lo, hi);
+            cy -= raw_add_n(a + lo, b, n);
+        }
+        // 3n/2n step on the low half
+        base_t ql = raw_div_2n1n(q, a + hi, b + hi, lo, tp, ws);
+        raw_mul_n(tp, b, hi, q, lo, ws);
+        cy = raw_sub_n(a, tp, n);
+        if (ql) cy += raw_sub_n(a + lo, b, hi);
+        while (cy) {
+            raw_dec_n(q, lo);
+            cy -= raw_add_n(a, b, n);
+        }
+        return qh;
+    }
+    // b must be normalized, the quotient is computed block by block with 2n/1n divisions
     BigInt_t &raw_dividediv_recursion(const BigInt_t &a, const BigInt_t &b, BigInt_t &r) {
-        if (a < b) {
+        if (a.raw_less(b)) {
             r = a;
             return set(0);
         } else if (b.size() <= BIGINT_DIVIDEDIV_THRESHOLD) {
             return raw_div(a, b, r);
         }
-        size_t base = (b.size() + 1) / 2;
-        if (a.size() <= base * 3) {
-            base = b.size() / 2;
-            BigInt_t ma = a, mb = b, e;
-            BigInt_t ha = ma.raw_shr_to(base);
-            BigInt_t hb = mb.raw_shr_to(base);
-            raw_dividediv_recursion(ha, hb, r);
-            ha = *this * b;
-            while (a < ha) {
-                ha.raw_sub(b);
-                raw_sub(BigInt_t(1));
-            }
-            r = a - ha;
-            return *this;
+        size_t n = b.size(), blocks = (a.size() - 1) / n;
+        std::vector<base_t> tp(n);
+        BigInt_t ws[3];
+        r.v.resize((blocks + 1) * n);
+        std::copy(a.v.begin(), a.v.end(), r.v.begin());
+        std::fill(r.v.begin() + a.size(), r.v.end(), 0);
+        v.assign(blocks * n + 1, 0);
+        sign = r.sign = 1;
+        base_t *rp = &r.v.front(), *qp = &v.front();
+        if (!raw_less_n(rp + blocks * n, &b.v.front(), n)) {
+            raw_sub_n(rp + blocks * n, &b.v.front(), n);
+            qp[blocks * n] = 1;
         }
-        if (a.size() > base * 4) base = a.size() / 2;
-        BigInt_t ha = a.raw_shr_to(base);
-        BigInt_t c, d, m;
-        raw_dividediv_recursion(ha, b, d);
-        raw_shl(base);
-        m.v.resize(base + d.size());
-        for (size_t i = 0; i < base; ++i)
-            m.v[i] = a.v[i];
-        for (size_t i = 0; i < d.size(); ++i)
-            m.v[base + i] = d.v[i];
-        c.raw_dividediv_recursion(m, b, r);
-        raw_add(c);
+        for (size_t i = blocks - 1; i < blocks; i--)
+            raw_div_2n1n(qp + i * n, rp + i * n, &b.v.front(), n, &tp.front(), ws);
+        r.v.resize(n);
+        r.trim();
+        trim();
         return *this;
     }
     BigInt_t &raw_dividediv(const BigInt_t &a, const BigInt_t &b, BigInt_t &r) {
-        if (b.size() <= BIGINT_DIVIDEDIV_THRESHOLD) {
+        if (b.size() <= BIGINT_DIVIDEDIV_THRESHOLD || a.raw_less(b)) {
             raw_div(a, b, r);
             return *this;
         }
@@ -236,16 +363,30 @@ protected:
             size_t shr = b.size() - ans_len;
             ta.raw_shr(shr);
             tb.raw_shr(shr);
-            return raw_dividediv(ta, tb, r);
+            raw_dividediv(ta, tb, r);
+            // the quotient of the top limbs can be off by a few, fix it with the whole numbers
+            BigInt_t t;
+            t.raw_mul(*this, b);
+            r = a;
+            sign = r.sign = t.sign = 1;
+            for (; r.raw_less(t); raw_sub(BigInt_t(1)))
+                t.raw_sub(b);
+            r.raw_sub(t);
+            for (; !r.raw_less(b); raw_add(BigInt_t(1)))
+                r.raw_sub(b);
+            return *this;
         }
-        carry_t mul = (carry_t)(((uint64_t)COMPRESS_MOD * COMPRESS_MOD - 1) /               //
-                                (*(b.v.begin() + b.v.size() - 1) * (uint64_t)COMPRESS_MOD + //
-                                 *(b.v.begin() + b.v.size() - 2) + 1));
+        // the top limb of a normalized divisor is already large enough
+        carry_t mul = 1;
+        if (b.v.back() < COMPRESS_MOD >> 1)
+            mul = (carry_t)(((uint64_t)COMPRESS_MOD * COMPRESS_MOD - 1) /               //
+                            (*(b.v.begin() + b.v.size() - 1) * (uint64_t)COMPRESS_MOD + //
+                             *(b.v.begin() + b.v.size() - 2) + 1));
         BigInt_t ma = a * BigInt_t(mul), mb = b * BigInt_t(mul);
         while (mb.v.back() < COMPRESS_MOD >> 1) {
             int32_t m = 2;
-            ma.raw_mul(ma, BigInt_t(m));
-            mb.raw_mul(mb, BigInt_t(m));
+            ma.raw_mul_int(m);
+            mb.raw_mul_int(m);
             mul *= m;
         }
         BigInt_t d;
@@ -259,6 +400,126 @@ protected:
             v.pop_back();
     }
     size_t size() const { return v.size(); }
+    // kernels for a machine integer operand, given as sign and magnitude
+    static size_t raw_split(base_t d[], uint64_t m) {
+        size_t k = 0;
+        do {
+            d[k++] = (base_t)(m % COMPRESS_MOD);
+            m /= COMPRESS_MOD;
+        } while (m);
+        return k;
+    }
+    int raw_cmp_small(uint64_t m) const {
+        base_t d[8];
+        size_t k = raw_split(d, m);
+        if (size() != k) return size() < k ? -1 : 1;
+        for (size_t i = k; i-- > 0;)
+            if (v[i] != d[i]) return v[i] < d[i] ? -1 : 1;
+        return 0;
+    }
+    int raw_cmp_small(bool neg, uint64_t m) const {
+        bool n = sign < 0 && !is_zero();
+        neg = neg && m;
+        if (n != neg) return n ? -1 : 1;
+        int c = raw_cmp_small(m);
+        return n ? -c : c;
+    }
+    BigInt_t &raw_set_small(bool neg, uint64_t m) {
+        base_t d[8] = {0};
+        size_t k = raw_split(d, m);
+        v.assign(d, d + k);
+        sign = neg && m ? -1 : 1;
+        return *this;
+    }
+    BigInt_t &raw_add_small(bool neg, uint64_t m) {
+        if (m == 0) return *this;
+        if (is_zero()) return raw_set_small(neg, m);
+        v.unshare();
+        if ((sign < 0) == neg) {
+            for (size_t i = 0; m; ++i) {
+                if (i == size()) v.push_back(0);
+                uint64_t t = m % COMPRESS_MOD + v[i];
+                v[i] = (base_t)(t % COMPRESS_MOD);
+                m = m / COMPRESS_MOD + t / COMPRESS_MOD;
+            }
+            return *this;
+        }
+        if (raw_cmp_small(m) < 0) {
+            // |*this| < m fits in the machine integer
+            uint64_t s = 0;
+            for (size_t i = size(); i-- > 0;)
+                s = s * COMPRESS_MOD + v[i];
+            return raw_set_small(neg, m - s);
+        }
+        for (size_t i = 0; m; ++i) {
+            uint64_t t = m % COMPRESS_MOD;
+            m /= COMPRESS_MOD;
+            if (v[i] >= t) {
+                v[i] -= (base_t)t;
+            } else {
+                v[i] = (base_t)(v[i] + COMPRESS_MOD - t);
+                ++m;
+            }
+        }
+        trim();
+        if (is_zero()) sign = 1;
+        return *this;
+    }
+    BigInt_t &raw_mul_small(bool neg, uint64_t m) {
+        if (m < (uint64_t)COMPRESS_MOD) {
+            raw_mul_int((base_t)m);
+        } else {
+            // multiply in place from the top limb down
+            base_t d[8];
+            size_t k = raw_split(d, m), n = size();
+            v.resize(n + k, 0);
+            for (size_t i = n; i-- > 0;) {
+                uint64_t x = v[i], c = 0;
+                v[i] = 0;
+                for (size_t j = 0; j < k; ++j) {
+                    c += x * d[j] + v[i + j];
+                    v[i + j] = (base_t)(c % COMPRESS_MOD);
+                    c /= COMPRESS_MOD;
+                }
+                for (size_t j = i + k; c; ++j) {
+                    c += v[j];
+                    v[j] = (base_t)(c % COMPRESS_MOD);
+                    c /= COMPRESS_MOD;
+                }
+            }
+            trim();
+        }
+        if (neg) sign = -sign;
+        if (is_zero()) sign = 1;
+        return *this;
+    }
+    BigInt_t &raw_div_small(bool neg, uint64_t m) {
+        if (m > ~(uint64_t)0 / COMPRESS_MOD) {
+            BigInt_t b;
+            return *this = *this / b.raw_set_small(neg, m);
+        }
+        v.unshare();
+        uint64_t r = 0;
+        for (size_t i = size(); i-- > 0;) {
+            r = r * COMPRESS_MOD + v[i];
+            v[i] = (base_t)(r / m);
+            r %= m;
+        }
+        trim();
+        if (neg) sign = -sign;
+        if (is_zero()) sign = 1;
+        return *this;
+    }
+    BigInt_t &raw_mod_small(uint64_t m) {
+        if (m > ~(uint64_t)0 / COMPRESS_MOD) {
+            BigInt_t b;
+            return *this = *this % b.raw_set_small(false, m);
+        }
+        uint64_t r = 0;
+        for (size_t i = size(); i-- > 0;)
+            r = (r * COMPRESS_MOD + v[i]) % m;
+        return raw_set_small(sign < 0, r);
+    }
     BigInt_t &from_str_base10(const char *s) {
         v.clear();
         int32_t base = 10, sign = 1, digits = COMPRESS_DIGITS;
@@ -286,6 +547,8 @@ protected:
 
 public:
     BigIntMini() { set(0); }
+    // zero, the limbs of this number are taken from the arena, which must outlive it
+    explicit BigIntMini(BigIntArena &arena) : v(arena) { set(0); }
     explicit BigIntMini(int n) { set(n); }
     explicit BigIntMini(intmax_t n) { set(n); }
     explicit BigIntMini(const char *s) { from_str(s); }
@@ -328,6 +591,7 @@ public:
         return raw_eq(b);
     }
     LESS_THAN_AND_EQUAL_COMPARABLE(BigInt_t)
+    BIGINT_ALL_INT_OPERATORS(BigInt_t)
 
     BigInt_t &operator=(intmax_t n) { return set(n); }
     BigInt_t &operator=(const char *s) { return from_str(s); }
@@ -337,7 +601,7 @@ public:
             r.raw_add(b);
         else
             r.raw_sub(b);
-        return BIGINT_STD_MOVE(r);
+        return r;
     }
     BigInt_t operator-(const BigInt_t &b) const {
         BigInt_t r = *this;
@@ -345,24 +609,24 @@ public:
             r.raw_add(b);
         else
             r.raw_sub(b);
-        return BIGINT_STD_MOVE(r);
+        return r;
     }
     BigInt_t operator-() const {
         BigInt_t r = *this;
         r.sign = -r.sign;
-        return BIGINT_STD_MOVE(r);
+        return r;
     }
     BigInt_t operator*(const BigInt_t &b) const {
         BigInt_t r;
         r.raw_mul_karatsuba(*this, b);
         r.sign = sign * b.sign;
-        return BIGINT_STD_MOVE(r);
+        return r;
     }
     BigInt_t operator/(const BigInt_t &b) const {
         BigInt_t r, d;
         d.raw_dividediv(*this, b, r);
         d.sign = sign * b.sign;
-        return BIGINT_STD_MOVE(d);
+        return d;
     }
     BigInt_t operator%(const BigInt_t &b) const { return BIGINT_STD_MOVE(*this - *this / b * b); }
     BigInt_t div(const BigInt_t &b, BigInt_t &r) {
@@ -373,7 +637,7 @@ public:
         BigInt_t d;
         d.raw_dividediv(*this, b, r);
         d.sign = sign * b.sign;
-        return BIGINT_STD_MOVE(d);
+        return d;
     }
 
     std::string out_dec() const {
@@ -7,6 +7,7 @@
 #include "bigint_hex.h"
 
 #include <iostream>
+#include <new>
 
 using namespace std;
 
@@ -432,8 +433,8 @@ bool test6_mod() {
 }
 
 bool test7_sqrt() {
-    BigIntHex ha, hal, har, ham;
-    BigIntDec hb, hbl, hbr, hbm;
+    BigIntHex ha, har;
+    BigIntDec hb, hbr;
     struct {
         const char *p1;
         const char *pa;
@@ -444,33 +445,25 @@ bool test7_sqrt() {
               {"", "", 0}};
     for (int i = 0; in[i].base; ++i) {
         ha.from_str(in[i].p1, in[i].base);
-        hal = 1;
-        har = ha;
-        while (hal < har) {
-            ham = (hal + har + BigIntHex().set(1)) / BigIntHex().set(2);
-            if (ham * ham > ha) {
-                har = ham - BigIntHex().set(1);
-            } else {
-                hal = ham;
-            }
+        if (isqrt_rem(ha, har).to_str(in[i].base) != in[i].pa) {
+            return false;
+        }
+        if (har < BigIntHex(0) || isqrt(ha) * isqrt(ha) + har != ha) {
+            return false;
         }
-        if (hal.to_str(in[i].base) != in[i].pa) {
+        if (iroot(ha * ha * ha, 6).to_str(in[i].base) != in[i].pa) {
             return false;
         }
     }
     for (int i = 0; in[i].base; ++i) {
         hb.from_str(in[i].p1, in[i].base);
-        hbl = 1;
-        hbr = hb;
-        while (hbl < hbr) {
-            hbm = (hbl + hbr + BigIntDec().set(1)) / BigIntDec().set(2);
-            if (hbm * hbm > hb) {
-                hbr = hbm - BigIntDec().set(1);
-            } else {
-                hbl = hbm;
-            }
+        if (isqrt_rem(hb, hbr).to_str(in[i].base) != in[i].pa) {
+            return false;
         }
-        if (hbl.to_str(in[i].base) != in[i].pa) {
+        if (hbr < BigIntDec(0) || isqrt(hb) * isqrt(hb) + hbr != hb) {
+            return false;
+        }
+        if (iroot(hb * hb * hb, 6).to_str(in[i].base) != in[i].pa) {
             return false;
         }
     }
@@ -521,6 +514,33 @@ bool test8_rnd_div(int ncase, int len) {
     return true;
 }
 
+bool test9_mont(int ncase, int len) {
+    BigIntHex a, b, m;
+    string sa, sb, sm;
+    char chars[] = "0123456789ABCDEF";
+    for (int i = 0; i < ncase; ++i) {
+        sa = chars[randint(1, 15)];
+        sb = chars[randint(1, 15)];
+        sm = chars[randint(1, 15)];
+        for (int j = 0; j < len; ++j) {
+            sa += chars[randint(0, 15)];
+            sb += chars[randint(0, 15)];
+            sm += chars[randint(0, 15)];
+        }
+        sm += chars[randint(0, 7) * 2 + 1];
+        a.from_str(sa, 16);
+        b.from_str(sb, 16);
+        m.from_str(sm, 16);
+        BigIntHexMont mont(m);
+        BigIntHex am = mont.to_mont(a), bm = mont.to_mont(b);
+        if (mont.from_mont(mont.mul(am, bm)) != a * b % m || mont.from_mont(mont.sqr(am)) != a * a % m) {
+            cout << "HEX: " << sa << " * " << sb << " mod " << sm << endl;
+            return false;
+        }
+    }
+    return true;
+}
+
 template <typename BigIntT> BigIntT fast_pow(int base, int exp) {
     BigIntT r(1), b(base);
     for (; exp; exp >>= 1) {
@@ -533,6 +553,231 @@ template <typename BigIntT> BigIntT fast_pow(int base, int exp) {
     return r;
 }
 
+bool test10_powmod(int ncase, int len) {
+    BigIntHex ha, he, hm;
+    BigIntDec da, de, dm;
+    string sa, se, sm;
+    char chars[] = "0123456789ABCDEF";
+    for (int i = 0; i < ncase; ++i) {
+        sa = chars[randint(1, 15)];
+        se = chars[randint(1, 15)];
+        sm = chars[randint(1, 15)];
+        for (int j = 0; j < len; ++j) {
+            sa += chars[randint(0, 15)];
+            se += chars[randint(0, 15)];
+            sm += chars[randint(0, 15)];
+        }
+        ha.from_str(sa, 16);
+        he.from_str(se, 16);
+        hm.from_str(sm, 16);
+        if (i & 1) ha = -ha;
+        da.from_str(ha.to_str().c_str());
+        de.from_str(he.to_str().c_str());
+        dm.from_str(hm.to_str().c_str());
+        string s1 = powmod(ha, he, hm).to_str(), s2 = powmod(da, de, dm).to_str();
+        if (s1 != s2 || BigIntDecPowTable(da, dm, len * 4 + 4).pow(de).to_str() != s2) {
+            cout << "powmod: " << sa << " ^ " << se << " mod " << sm << " = " << s2 << " out: " << s1 << endl;
+            return false;
+        }
+        if (BigIntHexPowTable(ha, hm, len * 4 + 4).pow(he).to_str() != s1) {
+            cout << "pow table: " << sa << " ^ " << se << " mod " << sm << " = " << s1 << endl;
+            return false;
+        }
+    }
+    // an even modulus goes through Barrett
+    BigIntHex t30 = pow(BigIntHex(10), 30);
+    if (BigIntHexPowTable(BigIntHex(3), t30, 64).pow(BigIntHex(12345)) != powmod(BigIntHex(3), BigIntHex(12345), t30) ||
+        powmod(BigIntHex(3), BigIntHex(12345), t30).is_zero()) {
+        cout << "pow table even" << endl;
+        return false;
+    }
+    for (int i = 0; i < 200; i += 7) {
+        if (pow(BigIntHex(3), i) != fast_pow<BigIntHex>(3, i) || pow(BigIntDec(-7), i) != fast_pow<BigIntDec>(-7, i)) {
+            cout << "pow: " << i << endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+// isqrt_rem of a by BigIntHex and BigIntDec
+bool check_isqrt(const BigIntHex &ha) {
+    BigIntHex hs, hr;
+    BigIntDec da(ha.to_str()), ds, dr;
+    hs = isqrt_rem(ha, hr);
+    ds = isqrt_rem(da, dr);
+    if (hs.to_str() != ds.to_str() || hr.to_str() != dr.to_str() || hr < 0 || hr > hs + hs || hs * hs + hr != ha) {
+        cout << "isqrt: " << ha.to_str(16) << " out: " << hs.to_str(16) << " " << ds.to_str() << endl;
+        return false;
+    }
+    return true;
+}
+
+bool test11_root(int ncase, int len) {
+    BigIntHex ha, hs;
+    BigIntDec da, ds;
+    string sa;
+    char chars[] = "0123456789ABCDEF";
+    for (int i = 0; i < ncase; ++i) {
+        sa = chars[randint(1, 15)];
+        for (int j = randint(0, len); j > 0; --j)
+            sa += chars[randint(0, 15)];
+        ha.from_str(sa, 16);
+        da.from_str(ha.to_str().c_str());
+        // the squares and their neighbours give the remainders 0 and 2s
+        hs = ha * ha;
+        if (!check_isqrt(ha) || !check_isqrt(hs) || !check_isqrt(hs - 1) || !check_isqrt(hs + ha + ha))
+            return false;
+        // the decimal top limbs just below a quarter with the nines below, a carry of the scaling reaches the top
+        string sd = string(1, (char)('1' + i % 3)) + string(i % 9, '4') + string(randint(1, len) + 40, '9');
+        if (!check_isqrt(BigIntHex(sd)) || !check_isqrt(BigIntHex(sd) + 1)) return false;
+        int k = randint(3, 20);
+        hs = iroot(ha, k);
+        ds = iroot(da, k);
+        if (hs.to_str() != ds.to_str() || pow(hs, k) > ha || pow(hs + BigIntHex(1), k) <= ha) {
+            cout << "iroot: " << sa << " k: " << k << " out: " << hs.to_str(16) << endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+bool test12_gcd(int ncase, int len) {
+    BigIntHex ha, hb, hg, hs, ht, hx, hy;
+    string sa, sb, sg;
+    char chars[] = "0123456789ABCDEF";
+    for (int i = 0; i < ncase; ++i) {
+        sa = chars[randint(1, 15)];
+        sb = chars[randint(1, 15)];
+        sg = chars[randint(1, 15)];
+        for (int j = randint(0, len); j > 0; --j)
+            sa += chars[randint(0, 15)];
+        for (int j = randint(0, len); j > 0; --j)
+            sb += chars[randint(0, 15)];
+        for (int j = randint(0, len / 4); j > 0; --j)
+            sg += chars[randint(0, 15)];
+        hg.from_str(sg, 16);
+        ha.from_str(sa, 16);
+        hb.from_str(sb, 16);
+        ha = ha * hg;
+        hb = hb * hg;
+        if (i & 1) ha = -ha;
+        for (hx = ha < BigIntHex(0) ? -ha : ha, hy = hb; !hy.is_zero();) {
+            hg = hx % hy;
+            hx = hy;
+            hy = hg;
+        }
+        if (gcd(ha, hb) != hx || gcdext(ha, hb, hs, ht) != hx || ha * hs + hb * ht != hx) {
+            cout << "gcd: " << sa << " " << sb << " " << sg << endl;
+            return false;
+        }
+        hy = invert(ha, hb);
+        if (hx == BigIntHex(1) ? (ha * hy - BigIntHex(1)) % hb != BigIntHex(0) : !hy.is_zero()) {
+            cout << "invert: " << sa << " " << sb << " " << sg << endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+// the terms of e = sum of 1 / k!
+struct ESeries {
+    void operator()(uint64_t k, BigIntHex &p, BigIntHex &q, BigIntHex &t) const {
+        p.set(1);
+        q.set(k ? (intmax_t)k : 1);
+        t.set(1);
+    }
+};
+
+// a zero sum over a negative Q
+struct ZeroSeries {
+    void operator()(uint64_t, BigIntHex &p, BigIntHex &q, BigIntHex &t) const {
+        p.set(1);
+        q.set(-1);
+        t.set(0);
+    }
+};
+
+// throws at the term k
+struct ThrowSeries {
+    uint64_t k;
+    void operator()(uint64_t i, BigIntHex &p, BigIntHex &q, BigIntHex &t) const {
+        if (i == k) throw std::bad_alloc();
+        p.set(1);
+        q.set(2);
+        t.set(1);
+    }
+};
+
+// the terms of pi by Chudnovsky, 426880 * sqrt(10005) / pi = sum of a(k) * p(1) ... p(k) / (q(1) ... q(k))
+struct ChudnovskySeries {
+    void operator()(uint64_t k, BigIntHex &p, BigIntHex &q, BigIntHex &t) const {
+        if (k == 0) {
+            p.set(1);
+            q.set(1);
+        } else {
+            p = -(BigIntHex((intmax_t)(6 * k - 5)) * BigIntHex((intmax_t)(2 * k - 1)) * BigIntHex((intmax_t)(6 * k - 1)));
+            q = BigIntHex((intmax_t)(k * k * k)) * pow(BigIntHex(640320), 3) / BigIntHex(24);
+        }
+        t = p * BigIntHex((intmax_t)(13591409 + 545140134 * k));
+    }
+};
+
+bool test13_split(int digits) {
+    const char *e = "2718281828459045235360287471352662497757247093699959574966967627724076630353547594571382178525166427";
+    const char *pi = "3141592653589793238462643383279502884197169399375105820974944592307816406286208998628034825342117067";
+    size_t limbs = digits / 9 + 2;
+    BigIntHex scale = pow(BigIntHex(2), limbs * 32), ten = pow(BigIntHex(10), digits);
+    ESeries es;
+    BigIntHex s = BigIntHexBinarySplit<ESeries>(es).sum(0, digits, limbs);
+    if ((s * ten / scale).to_str().compare(0, 100, e) != 0) {
+        cout << "split e: " << (s * ten / scale).to_str() << endl;
+        return false;
+    }
+    // the subtrees in threads with C++11, the same as one thread otherwise
+    if (BigIntHexBinarySplit<ESeries>(es, 4).sum(0, digits, limbs) != s) {
+        cout << "split threads" << endl;
+        return false;
+    }
+    ChudnovskySeries cs;
+    s = BigIntHexBinarySplit<ChudnovskySeries>(cs).sum(0, digits / 14 + 2, limbs);
+    s = BigIntHex(426880) * isqrt(BigIntHex(10005) * scale * scale) * scale / s;
+    if ((s * ten / scale).to_str().compare(0, 100, pi) != 0) {
+        cout << "split pi: " << (s * ten / scale).to_str() << endl;
+        return false;
+    }
+    BigIntHex P, Q, T, p, q, t, sp(1), sq(1), st(0);
+    BigIntHexBinarySplit<ChudnovskySeries>(cs).split(3, 40, P, Q, T);
+    for (uint64_t k = 3; k < 40; ++k) {
+        cs(k, p, q, t);
+        st = st * q + sp * t;
+        sp = sp * p;
+        sq = sq * q;
+    }
+    if (P != sp || Q != sq || T != st) return false;
+    ZeroSeries zs;
+    s = BigIntHexBinarySplit<ZeroSeries>(zs).sum(0, 5, limbs);
+    if (s != 0 || s < 0 || s.to_str() != "0") {
+        cout << "split zero: " << s.to_str() << endl;
+        return false;
+    }
+    // an exception of the left or of the right subtree reaches the caller after the threads are joined
+    for (uint64_t k = 0; k < 64; k += 21) {
+        ThrowSeries ts = {k};
+        bool thrown = false;
+        try {
+            BigIntHexBinarySplit<ThrowSeries>(ts, 4).sum(0, 64, 2);
+        } catch (const std::bad_alloc &) {
+            thrown = true;
+        }
+        if (!thrown) {
+            cout << "split throw: " << k << endl;
+            return false;
+        }
+    }
+    return true;
+}
+
 template <typename BigIntT> BigIntT Product(int n, BigIntT &currentN) {
     int m = n / 2;
     if (m == 0) return currentN = currentN + BigIntT(2);
@@ -573,6 +818,40 @@ template <typename BigIntT> BigIntT split_factorial(int n) {
 
 template <typename BigIntT> BigIntT calc_factorial(int fac) { return split_factorial<BigIntT>(fac); }
 
+template <> BigIntHex calc_factorial<BigIntHex>(int fac) { return BigIntHex::factorial(fac); }
+
+template <> BigIntDec calc_factorial<BigIntDec>(int fac) { return BigIntDec::factorial(fac); }
+
+bool test14_comb() {
+    BigIntHex hp(1);
+    for (int n = 0; n < 3000; n += n < 100 ? 1 : 97) {
+        BigIntHex hf = split_factorial<BigIntHex>(n);
+        if (BigIntHex::factorial(n) != hf || BigIntDec::factorial(n).to_str() != hf.to_str()) {
+            cout << "factorial: " << n << endl;
+            return false;
+        }
+        for (int k = 0; k <= n; k += n / 5 + 1) {
+            BigIntHex hb = hf / split_factorial<BigIntHex>(k) / split_factorial<BigIntHex>(n - k);
+            if (BigIntHex::binomial(n, k) != hb || BigIntDec::binomial(n, k).to_str() != hb.to_str()) {
+                cout << "binomial: " << n << " " << k << endl;
+                return false;
+            }
+        }
+    }
+    if (!BigIntHex::binomial(5, 6).is_zero()) return false;
+    for (int n = 2; n < 1000; ++n) {
+        bool prime = true;
+        for (int d = 2; d * d <= n; ++d)
+            if (n % d == 0) prime = false;
+        if (prime) hp = hp * BigIntHex(n);
+        if (BigIntHex::primorial(n) != hp || BigIntDec::primorial(n).to_str() != hp.to_str()) {
+            cout << "primorial: " << n << endl;
+            return false;
+        }
+    }
+    return true;
+}
+
 bool test_factorial() {
     BigIntHex ha;
     BigIntDec hb;
@@ -751,6 +1030,661 @@ template <class BIG> void test_efficiency(string classname) {
     }
 }
 
+bool test15_prime() {
+    std::vector<BigIntHex> c;
+    std::vector<char> sieve(20000, 1);
+    sieve[0] = sieve[1] = 0;
+    for (int i = 2; i < 20000; ++i) {
+        for (int j = i * i; sieve[i] && j < 20000; j += i)
+            sieve[j] = 0;
+        c.push_back(BigIntHex(i % 2 ? i : -i));
+    }
+    std::vector<char> r = is_probable_prime(c, 3);
+    for (int i = 2; i < 20000; ++i) {
+        if (r[i - 2] != sieve[i] || is_probable_prime(c[i - 2]) != (sieve[i] != 0)) {
+            cout << "prime: " << i << endl;
+            return false;
+        }
+    }
+    // pseudoprimes of the strong test or the Lucas test alone, without small factors
+    const char *psp[] = {"3825123056546413051", "318665857834031151167461", "3317044064679887385961981",
+                         "1000000007000000049"};
+    for (size_t i = 0; i < sizeof(psp) / sizeof(psp[0]); ++i) {
+        if (is_probable_prime(BigIntHex(psp[i]))) {
+            cout << "pseudoprime: " << psp[i] << endl;
+            return false;
+        }
+    }
+    // Mersenne primes
+    const int mp[] = {2, 3, 5, 7, 13, 17, 19, 31, 61, 89, 107, 127, 521, 607};
+    c.clear();
+    for (int p = 2; p < 700; ++p)
+        c.push_back(pow(BigIntHex(2), p) - BigIntHex(1));
+    r = is_probable_prime(c, 2);
+    for (int p = 2, k = 0; p < 700; ++p) {
+        bool prime = k < 14 && mp[k] == p;
+        if (prime) ++k;
+        if ((r[p - 2] != 0) != prime) {
+            cout << "mersenne: " << p << endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+bool test16_shift(int ncase, int len) {
+    BigIntHex ha, hp, hl, hr;
+    string sa;
+    char chars[] = "0123456789ABCDEF";
+    for (int i = 0; i < ncase; ++i) {
+        sa = chars[randint(1, 15)];
+        for (int j = randint(0, len); j > 0; --j)
+            sa += chars[randint(0, 15)];
+        ha.from_str(sa, 16);
+        if (i & 1) ha = -ha;
+        int n = randint(0, len * 4);
+        hp = pow(BigIntHex(2), n);
+        hl = ha << n;
+        hr = ha >> n;
+        // a >> n is the floor of a / 2^n
+        if (hl != ha * hp || hr * hp > ha || (hr + BigIntHex(1)) * hp <= ha || tdiv_r_2exp(ha, n) != ha - ha / hp * hp) {
+            cout << "shift: " << sa << " n: " << n << endl;
+            return false;
+        }
+        hl >>= n;
+        hp = hp * hr;
+        hr <<= n;
+        if (hl != ha || hr != hp) {
+            cout << "shift assign: " << sa << " n: " << n << endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+bool test17_bitwise(int ncase, int len) {
+    BigIntHex ha, hb, hc;
+    string sa, sb;
+    char chars[] = "0123456789ABCDEF";
+    for (int i = 0; i < 10000; ++i) {
+        int x = randint(-100000, 100000), y = randint(-100000, 100000), n = randint(0, 30);
+        ha = BigIntHex(x);
+        hb = BigIntHex(y);
+        if ((ha & hb) != BigIntHex(x & y) || (ha | hb) != BigIntHex(x | y) || (ha ^ hb) != BigIntHex(x ^ y) ||
+            ~ha != BigIntHex(~x) || ha.test_bit(n) != ((x >> n) & 1)) {
+            cout << "bitwise: " << x << " " << y << endl;
+            return false;
+        }
+    }
+    for (int i = 0; i < ncase; ++i) {
+        sa = chars[randint(1, 15)];
+        sb = chars[randint(1, 15)];
+        for (int j = randint(0, len); j > 0; --j)
+            sa += chars[randint(0, 15)];
+        for (int j = randint(0, len); j > 0; --j)
+            sb += chars[randint(0, 15)];
+        ha.from_str(sa, 16);
+        hb.from_str(sb, 16);
+        size_t bits = ha.bit_length(), ones = 0;
+        for (size_t j = 0; j < sa.size(); ++j)
+            for (int k = 0; k < 4; ++k)
+                ones += ((sa[j] <= '9' ? sa[j] - '0' : sa[j] - 'A' + 10) >> k) & 1;
+        if (bits != ha.to_str(2).size() || ha.popcount() != ones || !ha.test_bit(bits - 1) ||
+            (ha >> ha.count_trailing_zeros()).test_bit(0) != true) {
+            cout << "bit query: " << sa << endl;
+            return false;
+        }
+        if (i & 1) ha = -ha;
+        if (i & 2) hb = -hb;
+        // a + b = (a ^ b) + 2 (a & b), a | b = (a ^ b) + (a & b)
+        if (ha + hb != (ha ^ hb) + ((ha & hb) << 1) || (ha | hb) != (ha ^ hb) + (ha & hb) ||
+            ~(ha & hb) != (~ha | ~hb) || (ha ^ hb ^ hb) != ha) {
+            cout << "bitwise: " << sa << " " << sb << endl;
+            return false;
+        }
+        int n = randint(0, len * 4);
+        bool bit = ((ha >> n) & BigIntHex(1)) == BigIntHex(1);
+        hc = ha;
+        hc.set_bit(n, !bit);
+        if (ha.test_bit(n) != bit || hc.test_bit(n) == bit || (ha ^ hc) != BigIntHex(1) << n) {
+            cout << "set bit: " << sa << " n: " << n << endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+template <class BIG> bool test_intop(int ncase, int len) {
+    BIG ha, hb, hc;
+    string sa;
+    for (int i = 0; i < ncase; ++i) {
+        sa = (char)('0' + randint(1, 9));
+        for (int j = randint(0, len); j > 0; --j)
+            sa += (char)('0' + randint(0, 9));
+        ha.from_str(sa.c_str());
+        if (i & 1) ha = -ha;
+        uint64_t u = (uint64_t)randint(0, 0xffff) << 48 | (uint64_t)randint(0, 0xffffff) << 24 | randint(0, 0xffffff);
+        u >>= randint(0, 63);
+        int64_t s = (i & 2) ? -(int64_t)(u >> 1) : (int64_t)(u >> 1);
+        int32_t t = (int32_t)s;
+        hb = BIG((intmax_t)(u >> 1)) * BIG(2) + BIG((int)(u & 1));
+        if (ha + u != ha + hb || ha - u != ha - hb || ha * u != ha * hb ||
+            (u && (ha / u != ha / hb || ha % u != ha % hb)) || (ha < u) != (ha < hb) || (hb != u)) {
+            cout << "uint64 op: " << sa << " " << hb.to_str() << endl;
+            return false;
+        }
+        hb = BIG((intmax_t)s);
+        if (ha + s != ha + hb || ha - s != ha - hb || ha * s != ha * hb ||
+            (s && (ha / s != ha / hb || ha % s != ha % hb)) || (ha >= s) != (ha >= hb) || (hb != s)) {
+            cout << "int64 op: " << sa << " " << hb.to_str() << endl;
+            return false;
+        }
+        hb = BIG(t);
+        hc = ha;
+        hc += t;
+        hc *= t;
+        hc -= t;
+        if (t) hc %= t;
+        if (hc != (ha + hb) * hb - hb - (t ? ((ha + hb) * hb - hb) / hb * hb : BIG(0)) || (ha == t) != (ha == hb)) {
+            cout << "int32 op: " << sa << " " << t << endl;
+            return false;
+        }
+        // int64_t and uint64_t are only one of the spellings, size_t is another
+        long l = (long)t;
+        unsigned long ul = (unsigned long)(uint32_t)t;
+        bigint_llong_t ll = s;
+        bigint_ullong_t ull = u;
+        std::vector<char> w(i % 7);
+        hb = BIG((intmax_t)(u >> 1)) * BIG(2) + BIG((int)(u & 1));
+        if (ha * l != ha * BIG(t) || ha - ul != ha - BIG((intmax_t)(uint32_t)t) || ha + ll != ha + BIG((intmax_t)s) ||
+            ha * ull != ha * hb || (ha < ull) != (ha < hb) || ha * w.size() != ha * BIG((int)w.size()) ||
+            (ll && ha / ll != ha / BIG((intmax_t)s))) {
+            cout << "int types op: " << sa << " " << s << endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+bool test18_intop(int ncase, int len) {
+    return test_intop<BigIntHex>(ncase, len) && test_intop<BigIntDec>(ncase, len) && test_intop<BigIntMini>(ncase, len);
+}
+
+template <class BIG> bool test_rvalue(int ncase, int len) {
+    BIG ha, hb, hc, hd, he;
+    string sa, sb, sc;
+    for (int i = 0; i < ncase; ++i) {
+        sa = (char)('0' + randint(1, 9));
+        sb = (char)('0' + randint(1, 9));
+        sc = (char)('0' + randint(1, 9));
+        for (int j = randint(0, len); j > 0; --j)
+            sa += (char)('0' + randint(0, 9));
+        for (int j = randint(0, len); j > 0; --j)
+            sb += (char)('0' + randint(0, 9));
+        for (int j = randint(0, len); j > 0; --j)
+            sc += (char)('0' + randint(0, 9));
+        ha.from_str(sa.c_str());
+        hb.from_str(sb.c_str());
+        hc.from_str(sc.c_str());
+        if (i & 1) ha = -ha;
+        if (i & 2) hb = -hb;
+        // temporaries on either side reuse their buffers
+        hd = ha * hb;
+        hd += hc;
+        he = hc * hb;
+        he -= ha;
+        hd += he;
+        he = hd;
+        he /= hb;
+        if ((ha * hb + hc) + (hc * hb - ha) != hd || hc + ha * hb + (hc * hb - ha) != hd || (hd - hc * hb) - ha * hb != hc - ha ||
+            hd - (ha * hb + hc) != hc * hb - ha || (hd + hc) / hb != (he * hb + hd % hb + hc) / hb || (ha + hb) * hc != ha * hc + hb * hc) {
+            cout << "rvalue: " << sa << " " << sb << " " << sc << endl;
+            return false;
+        }
+        hd = (ha + hb) - (hb + ha);
+        if (hd != BIG(0) || hd < BIG(0) || ha - (hb + ha) != -hb) {
+            cout << "rvalue zero: " << sa << " " << sb << endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+bool test19_rvalue(int ncase, int len) { return test_rvalue<BigIntHex>(ncase, len) && test_rvalue<BigIntDec>(ncase, len); }
+
+// a request scoped computation that returns its result, t is on the arena and r keeps the heap
+BigIntHex arena_work(const BigIntHex &a, const BigIntHex &b) {
+    BigIntArena arena;
+    BigIntHex t(arena), r;
+    t = a;
+    t *= b;
+    r = t;
+    r += a;
+    return r;
+}
+
+bool test20_arena(int ncase, int len) {
+    BigIntHex ha, hb, hr, hs;
+    BigIntDec da, dr;
+    string sa, sb;
+    for (int i = 0; i < ncase; ++i) {
+        sa = (char)('0' + randint(1, 9));
+        sb = (char)('0' + randint(1, 9));
+        for (int j = randint(0, len); j > 0; --j)
+            sa += (char)('0' + randint(0, 9));
+        for (int j = randint(0, len); j > 0; --j)
+            sb += (char)('0' + randint(0, 9));
+        ha.from_str(sa);
+        hb.from_str(sb);
+        hs = (ha * hb + ha) / hb - ha % hb;
+        {
+            // x, y, dx and dy are on the arenas, hr, da and dr were created outside and keep the heap
+            BigIntArena arena(4096);
+            BigIntHex x(arena), y(arena);
+            x = ha;
+            y = hb;
+            hr = (x * y + x) / y - x % y;
+            {
+                BigIntArena inner;
+                BigIntDec dx(inner);
+                dx.from_str(sa);
+                da = dx * dx;
+            }
+            BigIntDec dy(arena);
+            dy.from_str(sb);
+            dr = dy * dy;
+        }
+        if (hr != hs || da != BigIntDec(sa) * BigIntDec(sa) || dr != BigIntDec(sb) * BigIntDec(sb)) {
+            cout << "arena: " << sa << " " << sb << endl;
+            return false;
+        }
+        BigIntHex w = arena_work(ha, hb);
+        if (w.to_str() != (ha * hb + ha).to_str()) {
+            cout << "arena return: " << sa << " " << sb << endl;
+            return false;
+        }
+    }
+    // the values pushed into an outer container are copies on the heap, they outlive the arena
+    std::vector<BigIntHex> out;
+    {
+        BigIntArena arena(4096);
+        BigIntHex x(arena);
+        x = ha;
+        out.push_back(x * x);
+        out.push_back(x);
+        // default constructed elements keep the heap too
+        out.resize(3);
+        out[2] = x;
+    }
+    {
+        // reuses the memory of the first arena
+        BigIntArena arena(4096);
+        BigIntHex x(arena);
+        x = hb * hb;
+        x += hb;
+    }
+    if (out[0] * hb != ha * ha * hb || out[1] != ha || out[2] != ha) {
+        cout << "arena container: " << sa << endl;
+        return false;
+    }
+    return true;
+}
+
+template <class BIG> bool test_expr(int ncase, int len) {
+    BIG ha, hb, hc, hd, he, hr;
+    string s[5];
+    for (int i = 0; i < ncase; ++i) {
+        for (int k = 0; k < 5; ++k) {
+            s[k] = (char)('0' + randint(1, 9));
+            for (int j = randint(0, len); j > 0; --j)
+                s[k] += (char)('0' + randint(0, 9));
+        }
+        ha.from_str(s[0].c_str());
+        hb.from_str(s[1].c_str());
+        hc.from_str(s[2].c_str());
+        hd.from_str(s[3].c_str());
+        he.from_str(s[4].c_str());
+        if (i & 1) ha = -ha;
+        if (i & 2) hd = -hd;
+        hr = lazy(ha) * hb + hc * lazy(hd) - he;
+        if (hr != ha * hb + hc * hd - he) {
+            cout << "expr: " << s[0] << " " << s[1] << " " << s[2] << " " << s[3] << " " << s[4] << endl;
+            return false;
+        }
+        hr = he - (lazy(ha) + hb) * (lazy(hc) - hd);
+        hr += lazy(ha) * hb;
+        hr -= lazy(hc) * hd;
+        if (hr != he - (ha + hb) * (hc - hd) + ha * hb - hc * hd) {
+            cout << "expr assign: " << s[0] << " " << s[1] << " " << s[2] << " " << s[3] << " " << s[4] << endl;
+            return false;
+        }
+        // the destination appears in the expression
+        hr = ha;
+        hr = lazy(hr) * hb - hr;
+        hd.addmul(hb, hc);
+        hd.submul(ha, he);
+        if (hr != ha * hb - ha || hd != BIG(s[3].c_str()) * BIG((i & 2) ? -1 : 1) + hb * hc - ha * he) {
+            cout << "expr alias: " << s[0] << " " << s[1] << " " << s[2] << " " << s[3] << " " << s[4] << endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+bool test21_expr(int ncase, int len) { return test_expr<BigIntHex>(ncase, len) && test_expr<BigIntDec>(ncase, len); }
+
+// operands with runs of zero limbs, so the split halves are zero or shorter than the split point
+bool test22_view(int ncase, int len) {
+    for (int i = 0; i < ncase; ++i) {
+        string sx, sy;
+        sx = (char)('0' + randint(1, 9));
+        for (int j = randint(0, len); j > 0; --j)
+            sx += (char)('0' + randint(0, 9));
+        sy = (i & 1) ? "0" : sx.substr(0, randint(1, (int)sx.size()));
+        BigIntHex ha = (BigIntHex(sx) << randint(0, len * 8)) + BigIntHex(sy), hb = BigIntHex(sx) << randint(0, len * 4);
+        string sa = ha.to_str(), sb = hb.to_str();
+        BigIntDec da(sa), db(sb);
+        string sz = sx + string(randint(1, len * 4), '0') + sy;
+        if (BigIntHex(sz).to_str() != sz || BigIntDec(sz).to_str() != sz) {
+            cout << "view parse: " << sz << endl;
+            return false;
+        }
+        if ((ha * hb).to_str() != (da * db).to_str() || (ha * ha).to_str() != (da * da).to_str()) {
+            cout << "view mul: " << sa << " " << sb << endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+// copies must keep value semantics, also when BIGINT_COW shares their buffers
+template <class BIG> bool test_cow(int ncase, int len) {
+    for (int i = 0; i < ncase; ++i) {
+        string sa = string(1, (char)('0' + randint(1, 9)));
+        for (int j = randint(0, len); j > 0; --j)
+            sa += (char)('0' + randint(0, 9));
+        BIG a(sa), one(1);
+        vector<BIG> vs(6, a);
+        BIG b = vs[0];
+        vs[1] += one;
+        vs[2] = vs[2] * vs[3];
+        vs[3] -= vs[3];
+        vs[4] = -vs[4];
+        vs[5] = vs[5] + vs[5];
+        std::swap(b, vs[0]);
+        if (a.to_str() != sa || b != a || vs[0] != a || vs[1] - one != a || vs[2] != a * a || !vs[3].is_zero() ||
+            vs[4] + a != 0 || vs[5] != a + a) {
+            cout << "cow: " << sa << endl;
+            return false;
+        }
+        // the in place kernels clone the shared limbs once before writing
+        vector<BIG> ws(4, a);
+        ws[0] *= 7;
+        ws[1] /= 3;
+        ws[2] += 5;
+        ws[3] -= a + one;
+        if (a.to_str() != sa || ws[0] != a * BIG(7) || ws[1] != a / BIG(3) || ws[2] != a + BIG(5) || ws[3] != -one) {
+            cout << "cow in place: " << sa << endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+bool test23_cow(int ncase, int len) { return test_cow<BigIntHex>(ncase, len) && test_cow<BigIntDec>(ncase, len); }
+
+// BigIntHexFixed<BITS> against BigIntHex modulo 2^BITS
+template <size_t BITS> bool test_fixed(int ncase) {
+    BigIntHex m = BigIntHex(1) << BITS;
+    for (int i = 0; i < ncase; ++i) {
+        string sa, sb;
+        sa = (char)('0' + randint(1, 9));
+        sb = (char)('0' + randint(1, 9));
+        for (int j = randint(0, BITS / 3); j > 0; --j)
+            sa += (char)('0' + randint(0, 9));
+        for (int j = randint(0, BITS / 3); j > 0; --j)
+            sb += (char)('0' + randint(0, 9));
+        BigIntHex a(sa), b(sb);
+        if (i & 1) a = -a;
+        BigIntHexFixed<BITS> x(a), y(b);
+        a %= m;
+        if (a < 0) a += m;
+        b %= m;
+        uint32_t s = randint(0, BITS + 8);
+        if (x.to_bigint() != a || BigIntHexFixed<BITS>(x.to_str()) != x || (x < y) != (a < b) ||
+            (x + y).to_bigint() != (a + b) % m || (x - y).to_bigint() != (a - b + m) % m || (x * y).to_bigint() != a * b % m ||
+            (x / y).to_bigint() != a / b || (x % y).to_bigint() != a % b || (-x).to_bigint() != (m - a) % m ||
+            (x << s).to_bigint() != (a << s) % m || (x >> s).to_bigint() != a >> s || (x ^ y).to_bigint() != (a ^ b)) {
+            cout << "fixed " << BITS << ": " << sa << " " << sb << endl;
+            return false;
+        }
+        // the integer operands keep their sign, x op n is reduced like x.to_bigint() op n
+        int n = randint(-100000, 100000);
+        uint64_t u = (uint64_t)randint(0, 1 << 30) << 33 | randint(0, 1 << 30);
+        BigIntHex bn(n), bu = BigIntHex() + u, mn = (a * bn) % m;
+        if (mn < 0) mn += m;
+        if ((x + n).to_bigint() != ((a + bn) % m + m) % m || (x - u).to_bigint() != ((a - bu) % m + m) % m ||
+            (x * n).to_bigint() != mn || (x * u).to_bigint() != a * bu % m || (x * 3u).to_bigint() != a * BigIntHex(3) % m ||
+            (x / 7).to_bigint() != a / BigIntHex(7) || (x / -7).to_bigint() != (m - a / BigIntHex(7)) % m ||
+            (x / u).to_bigint() != a / bu || (x % 1000u).to_bigint() != a % BigIntHex(1000) ||
+            (x % u).to_bigint() != a % bu || (x < n) != (a < bn) || (x == u) != (a == bu) || (x > -1) != true ||
+            (BigIntHexFixed<BITS>() == 0) != true || (x == 0) != a.is_zero() || (BigIntHexFixed<BITS>(n) == n) != (n >= 0)) {
+            cout << "fixed int " << BITS << ": " << sa << " " << n << " " << u << endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+bool test24_fixed(int ncase) {
+    return test_fixed<32>(ncase) && test_fixed<64>(ncase) && test_fixed<256>(ncase) && test_fixed<1024>(ncase);
+}
+
+// small square products, with all bits set for the longest carry chains
+bool test25_comba(int ncase) {
+    for (int i = 0; i < ncase; ++i) {
+        for (int n = 1; n <= 16; ++n) {
+            BigIntHex a = (BigIntHex(1) << (32 * n)) - 1, b = a;
+            if (i) {
+                a = BigIntHex(randint(1, 1 << 30));
+                b = BigIntHex(randint(1, 1 << 30));
+                for (int j = 1; j < n; ++j) {
+                    a = (a << 32) + BigIntHex(randint(0, 1 << 30)) * BigIntHex(randint(1, 4));
+                    b = (b << 32) + BigIntHex(randint(0, 1 << 30)) * BigIntHex(randint(1, 4));
+                }
+            }
+            if ((a * b).to_str() != (BigIntDec(a.to_str()) * BigIntDec(b.to_str())).to_str()) {
+                cout << "comba: " << a.to_str() << " " << b.to_str() << endl;
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// long runs of carries and borrows through limbs at the maximum digit
+template <class BIG> bool test_carry(int len) {
+    for (int n = 1; n <= len; n += randint(1, 9)) {
+        string nines(n, '9'), one = "1", p = "1" + string(n, '0');
+        BIG a(nines.c_str()), b(one.c_str()), c(p.c_str());
+        if ((a + b).to_str() != p || (c - b).to_str() != nines || (c - a).to_str() != one || (a - c).to_str() != "-" + one ||
+            (b + a).to_str() != p || (a + a + b + b).to_str() != "2" + string(n, '0')) {
+            cout << "carry: " << n << endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+bool test26_carry(int len) { return test_carry<BigIntDec>(len) && test_carry<BigIntMini>(len) && test_carry<BigIntHex>(len); }
+
+// schoolbook products of the decimal class, the columns of all nines products are the largest
+bool test27_columns(int ncase) {
+    for (int i = 0; i < ncase; ++i) {
+        int n = randint(1, 800), m = randint(1, 800);
+        string sa(n, '9'), sb(m, '9');
+        if (i) {
+            sa = string(1, (char)('0' + randint(1, 9)));
+            sb = string(1, (char)('0' + randint(1, 9)));
+            for (int j = 1; j < n; ++j)
+                sa += (char)('0' + randint(0, 9));
+            for (int j = 1; j < m; ++j)
+                sb += (char)('0' + randint(0, 9));
+        }
+        BigIntDec a(sa.c_str()), b(sb.c_str());
+        if ((a * b).to_str() != (BigIntHex(sa.c_str()) * BigIntHex(sb.c_str())).to_str()) {
+            cout << "columns: " << sa << " " << sb << endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+// sums of signed values and small multiples, the large multiples make the lanes normalise
+template <class BIG, class ACC> bool test_accum(int ncase) {
+    for (int i = 0; i < ncase; ++i) {
+        ACC acc;
+        BIG ref;
+        for (int k = randint(0, 50); k > 0; --k) {
+            string s = randint(0, 1) ? "-" : "";
+            s += (char)('0' + randint(1, 9));
+            for (int j = randint(0, 300); j > 0; --j)
+                s += (char)('0' + randint(0, 9));
+            BIG a(s.c_str());
+            int32_t m = randint(0, 1) ? randint(-1000, 1000) : randint(1 << 28, 1 << 30) * (randint(0, 1) ? 2 : -2);
+            int op = randint(0, 2);
+            if (op == 0)
+                acc += a, ref += a;
+            else if (op == 1)
+                acc -= a, ref -= a;
+            else
+                acc.addmul(a, m), ref += a * BIG((intmax_t)m);
+        }
+        if (acc.value().to_str() != ref.to_str()) {
+            cout << "accum: " << acc.value().to_str() << " " << ref.to_str() << endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+bool test28_accum(int ncase) { return test_accum<BigIntHex, BigIntHexAccum>(ncase) && test_accum<BigIntDec, BigIntDecAccum>(ncase); }
+
+// sums of products, the large pairs go through the transform domain
+template <class BIG> bool test_dot(int ncase, int len) {
+    for (int i = 0; i < ncase; ++i) {
+        vector<BIG> a, b;
+        BIG ref;
+        for (int k = randint(0, 6); k > 0; --k) {
+            string sa = randint(0, 1) ? "-" : "", sb = randint(0, 1) ? "-" : "";
+            sa += string(randint(1, len), '9');
+            sb += string(randint(1, len), '9');
+            if (randint(0, 1)) sa[sa.size() - 1] = (char)('0' + randint(0, 8));
+            a.push_back(BIG(sa.c_str()));
+            b.push_back(randint(0, 3) ? BIG(sb.c_str()) : a.back());
+            ref += a.back() * b.back();
+        }
+        if (dot(a, b).to_str() != ref.to_str()) {
+            cout << "dot: " << i << endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+// n products of the same length and sign with nearly all bits set, more than one transform can sum
+// without overflow, so the group is flushed part way
+bool test_dot_flush(int n, uint64_t bits) {
+    BigIntHex x = (BigIntHex(1) << bits) - BigIntHex(1), y = x - BigIntHex(12345), ref;
+    vector<BigIntHex> a, b;
+    for (int i = 0; i < n; ++i) {
+        a.push_back(x - BigIntHex(i));
+        b.push_back(y - BigIntHex(i * 7));
+        ref += a.back() * b.back();
+    }
+    if (dot(a, b) != ref) {
+        cout << "dot flush: " << n << endl;
+        return false;
+    }
+    return true;
+}
+
+bool test29_dot(int ncase, int len) {
+    return test_dot<BigIntHex>(ncase, len) && test_dot<BigIntDec>(ncase, len) && test_dot_flush(100, 500000);
+}
+
+// the convolutions mod p and exact, and the polynomials with signed coefficients, against the schoolbook
+bool test30_poly(int ncase) {
+    // 3 is a primitive root of both, 64000193 - 1 = 2^6 * 1000003 so its products are split
+    const int32_t P3 = 469762049, P4 = 64000193;
+    NTT_NS::ConvMod<NTT_NS::NTT_P2> cm;
+    NTT_NS::ConvMod<P3> cm3;
+    NTT_NS::ConvMod<P4> cm4;
+    NTT_NS::ConvExact ce;
+    {
+        // the longest product of one transform with all the coefficients at the maximum
+        NTT_NS::ConvMod<NTT_NS::NTT_P1> cm1;
+        size_t n = std::min(cm1.max_len() / 2, (size_t)1 << 20);
+        vector<uint32_t> a(n, 65535), r;
+        vector<uint64_t> re;
+        cm1.mul(a, a, r);
+        ce.mul(a, a, re);
+        if (r.size() != n * 2 - 1 || re.size() != n * 2 - 1) return false;
+        for (size_t k = 0; k < n * 2 - 1; ++k) {
+            uint64_t s = (uint64_t)std::min(k + 1, n * 2 - 1 - k) * 65535 * 65535;
+            if (re[k] != s || r[k] != s % NTT_NS::NTT_P1) {
+                cout << "conv bound: " << n << " " << k << endl;
+                return false;
+            }
+        }
+    }
+    for (int i = 0; i < ncase; ++i) {
+        size_t n = randint(1, 200), m = randint(1, 200);
+        vector<uint32_t> a(n), b(m), r;
+        vector<uint64_t> re;
+        for (size_t j = 0; j < n; ++j)
+            a[j] = (uint32_t)randint(0, 65535) << 15 | randint(0, 32767);
+        for (size_t j = 0; j < m; ++j)
+            b[j] = (uint32_t)randint(0, 65535);
+        vector<uint32_t> r3, r4;
+        cm.mul(a, b, r);
+        cm3.mul(a, b, r3);
+        cm4.mul(a, b, r4);
+        ce.mul(a, b, re);
+        if (r.size() != n + m - 1 || r3.size() != n + m - 1 || r4.size() != n + m - 1 || re.size() != n + m - 1)
+            return false;
+        for (size_t k = 0; k < n + m - 1; ++k) {
+            uint64_t s = 0, sm = 0, s3 = 0, s4 = 0;
+            for (size_t j = k < m ? 0 : k - m + 1; j <= k && j < n; ++j) {
+                s += (uint64_t)a[j] * b[k - j];
+                sm = (sm + (uint64_t)a[j] * b[k - j] % NTT_NS::NTT_P2) % NTT_NS::NTT_P2;
+                s3 = (s3 + (uint64_t)a[j] * b[k - j] % P3) % P3;
+                s4 = (s4 + (uint64_t)a[j] * b[k - j] % P4) % P4;
+            }
+            if (re[k] != s || r[k] != sm || r3[k] != s3 || r4[k] != s4) {
+                cout << "conv: " << k << endl;
+                return false;
+            }
+        }
+        vector<BigIntHex> pa(randint(1, 30)), pb(randint(1, 30));
+        for (size_t j = 0; j < pa.size(); ++j)
+            pa[j] = (BigIntHex(randint(0, 1 << 30)) << randint(0, 200)) - BigIntHex(randint(0, 1 << 30));
+        for (size_t j = 0; j < pb.size(); ++j)
+            pb[j] = randint(0, 3) ? -(BigIntHex(randint(0, 1 << 30)) << randint(0, 200)) : BigIntHex(0);
+        vector<BigIntHex> pr = poly_mul(pa, pb);
+        for (size_t k = 0; k < pr.size(); ++k) {
+            BigIntHex s;
+            for (size_t j = k < pb.size() ? 0 : k - pb.size() + 1; j <= k && j < pa.size(); ++j)
+                s += pa[j] * pb[k - j];
+            if (pr[k].to_str() != s.to_str()) {
+                cout << "poly: " << k << " " << pr[k].to_str() << " " << s.to_str() << endl;
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
 int main() {
     bool pass = true;
     cout << "test1_parse : " << ((pass = test1_parse()) ? "pass" : "FAIL") << endl;
@@ -769,6 +1703,76 @@ int main() {
     if (!pass) return -1;
     cout << "test8_rnddiv: " << ((pass = test8_rnd_div(10, 256)) ? "pass" : "FAIL") << endl;
     if (!pass) return -1;
+    cout << "test8_rnddiv: " << ((pass = test8_rnd_div(4, 4096)) ? "pass" : "FAIL") << endl;
+    if (!pass) return -1;
+    cout << "test9_mont  : " << ((pass = test9_mont(10, 256)) ? "pass" : "FAIL") << endl;
+    if (!pass) return -1;
+    cout << "test9_mont  : " << ((pass = test9_mont(2, 16384)) ? "pass" : "FAIL") << endl;
+    if (!pass) return -1;
+    cout << "test10_pow  : " << ((pass = test10_powmod(10, 64)) ? "pass" : "FAIL") << endl;
+    if (!pass) return -1;
+    cout << "test10_pow  : " << ((pass = test10_powmod(2, 1024)) ? "pass" : "FAIL") << endl;
+    if (!pass) return -1;
+    cout << "test11_root : " << ((pass = test11_root(100, 100)) ? "pass" : "FAIL") << endl;
+    if (!pass) return -1;
+    cout << "test11_root : " << ((pass = test11_root(3, 20000)) ? "pass" : "FAIL") << endl;
+    if (!pass) return -1;
+    cout << "test12_gcd  : " << ((pass = test12_gcd(100, 200)) ? "pass" : "FAIL") << endl;
+    if (!pass) return -1;
+    cout << "test12_gcd  : " << ((pass = test12_gcd(4, 40000)) ? "pass" : "FAIL") << endl;
+    if (!pass) return -1;
+    cout << "test13_split: " << ((pass = test13_split(1000)) ? "pass" : "FAIL") << endl;
+    if (!pass) return -1;
+    cout << "test13_split: " << ((pass = test13_split(100000)) ? "pass" : "FAIL") << endl;
+    if (!pass) return -1;
+    cout << "test14_comb : " << ((pass = test14_comb()) ? "pass" : "FAIL") << endl;
+    if (!pass) return -1;
+    cout << "test15_prime: " << ((pass = test15_prime()) ? "pass" : "FAIL") << endl;
+    if (!pass) return -1;
+    cout << "test16_shift: " << ((pass = test16_shift(1000, 100)) ? "pass" : "FAIL") << endl;
+    if (!pass) return -1;
+    cout << "test16_shift: " << ((pass = test16_shift(10, 100000)) ? "pass" : "FAIL") << endl;
+    if (!pass) return -1;
+    cout << "test17_bit  : " << ((pass = test17_bitwise(1000, 100)) ? "pass" : "FAIL") << endl;
+    if (!pass) return -1;
+    cout << "test17_bit  : " << ((pass = test17_bitwise(10, 10000)) ? "pass" : "FAIL") << endl;
+    if (!pass) return -1;
+    cout << "test18_intop: " << ((pass = test18_intop(1000, 50)) ? "pass" : "FAIL") << endl;
+    if (!pass) return -1;
+    cout << "test18_intop: " << ((pass = test18_intop(10, 5000)) ? "pass" : "FAIL") << endl;
+    if (!pass) return -1;
+    cout << "test19_rval : " << ((pass = test19_rvalue(1000, 50)) ? "pass" : "FAIL") << endl;
+    if (!pass) return -1;
+    cout << "test19_rval : " << ((pass = test19_rvalue(10, 5000)) ? "pass" : "FAIL") << endl;
+    if (!pass) return -1;
+    cout << "test20_arena: " << ((pass = test20_arena(1000, 50)) ? "pass" : "FAIL") << endl;
+    if (!pass) return -1;
+    cout << "test20_arena: " << ((pass = test20_arena(10, 5000)) ? "pass" : "FAIL") << endl;
+    if (!pass) return -1;
+    cout << "test21_expr : " << ((pass = test21_expr(1000, 50)) ? "pass" : "FAIL") << endl;
+    if (!pass) return -1;
+    cout << "test21_expr : " << ((pass = test21_expr(10, 5000)) ? "pass" : "FAIL") << endl;
+    if (!pass) return -1;
+    cout << "test22_view : " << ((pass = test22_view(100, 500)) ? "pass" : "FAIL") << endl;
+    if (!pass) return -1;
+    cout << "test22_view : " << ((pass = test22_view(4, 20000)) ? "pass" : "FAIL") << endl;
+    if (!pass) return -1;
+    cout << "test23_cow  : " << ((pass = test23_cow(100, 500)) ? "pass" : "FAIL") << endl;
+    if (!pass) return -1;
+    cout << "test24_fixed: " << ((pass = test24_fixed(1000)) ? "pass" : "FAIL") << endl;
+    if (!pass) return -1;
+    cout << "test25_comba: " << ((pass = test25_comba(1000)) ? "pass" : "FAIL") << endl;
+    if (!pass) return -1;
+    cout << "test26_carry: " << ((pass = test26_carry(2000)) ? "pass" : "FAIL") << endl;
+    if (!pass) return -1;
+    cout << "test27_column: " << ((pass = test27_columns(300)) ? "pass" : "FAIL") << endl;
+    if (!pass) return -1;
+    cout << "test28_accum: " << ((pass = test28_accum(300)) ? "pass" : "FAIL") << endl;
+    if (!pass) return -1;
+    cout << "test29_dot  : " << ((pass = test29_dot(20, 100000)) ? "pass" : "FAIL") << endl;
+    if (!pass) return -1;
+    cout << "test30_poly : " << ((pass = test30_poly(300)) ? "pass" : "FAIL") << endl;
+    if (!pass) return -1;
     pass = test_bigdivrnd(1 << 14, 1 << 11);
     if (!pass) {
         cout << "test_bigdivrnd FAIL" << endl;